@@ -0,0 +1,27 @@
+# Configuration for the hash function benchmarks
+from parser import Description
+
+hash_throughput = Description(
+    'Hash_Throughput',
+    legend = 'nanoseconds per key',
+    description = 'Hash throughput',
+    details = """
+Hashes n keys, random integers or random strings (the length is the second argument), and sums the hashes. The hashes
+do not depend on each other so the CPU computes several of them at the same time: this is the cost of hashing a batch
+of keys, like when filling a hashmap.
+"""
+)
+
+hash_latency = Description(
+    'Hash_Latency',
+    legend = 'nanoseconds per key',
+    description = 'Hash latency',
+    details = """
+Hashes n keys, the next key to hash depending on the bit 0 of the previous hash, so each hash waits for the previous
+one: this is the cost of hashing a single key before a lookup.
+"""
+)
+
+descriptions = dict()
+descriptions[hash_throughput.name] = hash_throughput
+descriptions[hash_latency.name] = hash_latency
@@ -16,10 +16,10 @@ rehash = Description(
     global_timing = True,
     description = 'Rehash benchmark',
     details = """
-Measures the time taken to insert an element which will lead to a rehash.\n
-To do so the test inserts until the reserved size and then continue until there is a "costly" insert is hapening. Most of the
-hashmap implementation do not support unconditional rehash so that an approximation. In practise for the hashmap tested the
-rehash is slow compare to the insert so this seems to work pretty well.
+Measures the time taken to rehash a map of n elements.\n
+The maps supporting an unconditional rehash (absl, yoshi) are rehashed directly. For the others the test inserts until
+the reserved size and then continues until a "costly" insert happens, an approximation: in practice the rehash is slow
+compared to the insert so this works pretty well.
 """
 )
 
@@ -36,7 +36,187 @@ This simulate data processing such as financial market data processing.
 """
 )
 
+concurrent_mixed = Description(
+    'Concurrent_Mixed',
+    x_axis = 'threads',
+    value = 'items_per_second',
+    legend = 'operations per second (all threads)',
+    description = 'Concurrent reads and writes on a shared map',
+    details = """
+The map is filled with n keys and shared by all the threads. Each thread does random finds and, for the
+remaining percentage (second argument), erases a random key and inserts it back on its next write.\n
+The plot shows the total throughput per number of threads, a design stops scaling where the curve flattens.
+"""
+)
+
+memory_footprint = Description(
+    'Memory_Footprint',
+    value = 'bytes_per_entry',
+    legend = 'bytes per entry',
+    description = 'Memory footprint',
+    details = """
+Inserts n keys in random order without reserving and tracks all the allocations done meanwhile (global operator
+new/delete). The plot shows the bytes still allocated divided by the number of entries, the extra charts the number
+of allocations per entry and the peak of allocated bytes. Node based maps do one allocation per entry while flat maps
+only allocate their table.
+"""
+)
+
+growth_timeline = Description(
+    'Growth_Timeline',
+    value = 'stall_ns',
+    legend = 'slowest insert (ns)',
+    description = 'Growth stalls',
+    details = """
+Inserts n keys in random order without reserving and times each insert. The plot shows the slowest insert, usually the
+one growing the map, the extra charts the number of stalls (inserts 100 times slower than the median), the peak of
+allocated bytes, the previous and the new table being both alive during a growth, and its ratio to the final size.
+yoshi::IncrementalMap spreads the growth over the following inserts instead.
+"""
+)
+
+iterate_after_erase = Description(
+    'Iterate_AfterErase',
+    description = 'Iteration after erasing 90% of the map',
+    details = """
+Inserts n keys, erases 90% of them and reads the keys of the remaining ones in the iteration order. The time is per
+key inserted: the flat maps do not shrink so the scan goes through all the empty slots and tombstones, while the
+node based maps only follow their remaining nodes (and the empty buckets). The extra charts show the footprint of
+the map, its bytes allocated and a bound of the memory a scan reads, in total and per remaining element.
+"""
+)
+
+find_batch_prefetch = Description(
+    'Find_Batch_Prefetch',
+    description = 'Batched find with software prefetching',
+    details = """
+Same lookups as Find_Batch_Naive: n keys are inserted then all of them are found in a random order by batches
+(second argument). Here the memory of all the keys of a batch is prefetched first (absl and yoshi prefetch, folly F14
+prehash) and then the keys are looked up, with the hash of prehash for F14, so the cache misses of a batch overlap.
+Only the maps with such an API run it.
+"""
+)
+
+find_string_view = Description(
+    'Find_String_View',
+    description = 'Find string keys from std::string_view',
+    details = """
+Same lookups as Find_String, the keys being given as std::string_view. The hashmaps with a transparent hasher and
+equality find them as is, the others construct a temporary std::string which allocates for the keys longer than 15
+characters (see the allocations_per_find counter). The last template argument is the distribution of the key lengths.
+"""
+)
+
+replay_trace = Description(
+    'Replay_Trace',
+    value = 'items_per_second',
+    legend = 'events per second',
+    description = 'Order book trace replay',
+    details = """
+Replays a trace of order book events on an empty hashmap keyed by the order ids: an add inserts the order, a modify
+updates its value and a cancel erases it. The value is the payload size of the event, or a string of that size.
+
+Without --trace the trace is synthetic (see trace_generator): increasing order ids, log-normal lifetimes and a few
+modifications per order. With --trace the recorded events are replayed, the size being the number of events.
+"""
+)
+
+upsert = Description(
+    'Upsert',
+    description = 'Writes of existing keys by call shape',
+    details = """
+Inserts n keys and writes 1.1 n keys in a random order, 10 existing ones for a new one, through the call shape given
+as last template argument: insert, emplace, try_emplace, insert_or_assign, operator[] or extract and insert of the
+node. The extra charts show the allocations and the copies and moves of the values per call: emplace may build a node
+before finding the key is there, insert builds a std::pair, extract reuses the node. The maps without one of the calls
+use the closest one (see the Adapter).
+"""
+)
+
+startup_first_lookup = Description(
+    'Startup_FirstLookup',
+    description = 'Time from an existing table to its first lookup',
+    details = """
+Time to get a table of n entries ready and find one key in it. yoshi::MappedMap is written once in a file (in
+/dev/shm when available) and then only mapped read only: the time is the one of the mapping and of the page faults of
+the lookup. The other hashmaps are rebuilt from the n entries after reserving, like when loading a snapshot. The
+file size is given by the file_bytes counter.
+"""
+)
+
+snapshot_save = Description(
+    'Snapshot_Save',
+    value = 'bytes_per_second',
+    legend = 'bytes per second',
+    description = 'Write a map to a snapshot',
+    details = """
+Writes the n elements of a map to a snapshot: a header followed by the keys and values as raw bytes, or by the image
+of the table for the maps without pointers (ByImage with yoshi::MappedMap). InMemory writes a buffer, Streamed a file
+of the temporary directory by chunks of 1MB. The snapshot size is given by the snapshot_bytes counter.
+"""
+)
+
+snapshot_load = Description(
+    'Snapshot_Load',
+    value = 'bytes_per_second',
+    legend = 'bytes per second',
+    description = 'Restore a map from a snapshot',
+    details = """
+Restores a map of n elements from its snapshot (see Snapshot_Save): ByReinsert inserts the elements one by one without
+reserving, ByPresized reserves the size of the snapshot first and ByImage copies the image of the table (only for the
+maps without pointers). The extra charts show the bytes per entry of the loaded map and the peak of memory during the
+load, the snapshot buffer included for InMemory while Streamed only holds a chunk of the file.
+"""
+)
+
+clear_reuse = Description(
+    'Clear_Reuse',
+    description = 'Clear a map and fill it again',
+    details = """
+Clears a map of n elements and inserts the same n keys again, like a map reused from one session to the next. The
+flat maps keep their table on clear and do not allocate, the node based maps free and allocate every node again (see
+the extra charts). Clear_Full times the clear alone, Copy, Move and Destroy the other steps of the life of a map.
+"""
+)
+
+cache_access = Description(
+    'Cache_Access',
+    description = 'Access a bounded cache built on a map',
+    details = """
+Accesses a full cache of a percentage of the n keys with n keys drawn uniformly or with a Zipf distribution, a miss
+inserting the key and evicting an entry: ListLru links its entries in a std::list, FlatLru in a vector by their
+indexes and ClockCache approximates the least recently used entry with reference bits. The time per access includes
+the evictions, the extra charts show the hit rate and the evictions per access.
+"""
+)
+
+churn_timeline = Description(
+    'Churn_Timeline',
+    value = 'stall_ns',
+    legend = 'slowest erase and insert (ns)',
+    description = 'Churn stalls',
+    details = """
+Fills a map with n keys, then erases the oldest key and inserts a new one 2n times, timing each pair. The size stays
+the same, but the erased slots of the flat maps become tombstones which the table drops by rehashing once they fill
+it: the plot shows the slowest pair, usually this rehash. yoshi::IncrementalMap migrates to a new table instead.
+"""
+)
+
 descriptions = dict()
 descriptions[rehash.name] = rehash
 descriptions[insert_erase_random.name] = insert_erase_random
 descriptions[insert_sequential.name] = insert_sequential
+descriptions[concurrent_mixed.name] = concurrent_mixed
+descriptions[memory_footprint.name] = memory_footprint
+descriptions[growth_timeline.name] = growth_timeline
+descriptions[churn_timeline.name] = churn_timeline
+descriptions[iterate_after_erase.name] = iterate_after_erase
+descriptions[find_batch_prefetch.name] = find_batch_prefetch
+descriptions[find_string_view.name] = find_string_view
+descriptions[replay_trace.name] = replay_trace
+descriptions[upsert.name] = upsert
+descriptions[startup_first_lookup.name] = startup_first_lookup
+descriptions[snapshot_save.name] = snapshot_save
+descriptions[snapshot_load.name] = snapshot_load
+descriptions[clear_reuse.name] = clear_reuse
+descriptions[cache_access.name] = cache_access
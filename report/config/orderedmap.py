@@ -0,0 +1,33 @@
+# Configuration for the ordered map benchmarks
+from parser import Description
+
+lower_bound_random = Description(
+    'LowerBound_Random',
+    description = 'Random lower bound',
+    details = """
+Inserts the n even keys [0, 2n[ in random order and finds the lower bound of the odd keys in random order, so each lookup
+ends between 2 elements like the search of a price level in an order book.
+"""
+)
+
+range_scan = Description(
+    'Range_Scan',
+    description = 'Range scan',
+    details = """
+Reads the values of k consecutive elements (the second argument) from the lower bound of random keys, n / k times. The
+first element costs a lookup, the next ones measure how contiguous the elements are in memory.
+"""
+)
+
+iterate = Description(
+    'Iterate',
+    description = 'In-order iteration',
+    details = """
+Reads all the values in order. The map is built by random inserts, so the nodes of std::map are spread in memory.
+"""
+)
+
+descriptions = dict()
+descriptions[lower_bound_random.name] = lower_bound_random
+descriptions[range_scan.name] = range_scan
+descriptions[iterate.name] = iterate
@@ -0,0 +1,30 @@
+# Configuration for the queue benchmarks
+from parser import Description
+
+round_trip_latency = Description(
+    'RoundTrip_Latency',
+    value = 'p50_ns',
+    legend = 'median round trip (ns)',
+    description = 'Round trip latency',
+    details = """
+A thread sends a timestamp to a second thread which sends it back on another queue. The plot shows the median round
+trip, the percentile chart the tail. The placement of the 2 threads is given with --cpus: 2 hyperthreads of a core,
+2 cores of a socket or 2 sockets.
+"""
+)
+
+throughput = Description(
+    'Throughput',
+    x_axis = 'threads',
+    value = 'items_per_second',
+    legend = 'messages per second',
+    description = 'Throughput',
+    details = """
+1 to N producers (the number of threads minus one) push messages as fast as they can to a single consumer. The plot
+shows the messages popped per second; the single producer queues only run with one producer.
+"""
+)
+
+descriptions = dict()
+descriptions[round_trip_latency.name] = round_trip_latency
+descriptions[throughput.name] = throughput
@@ -22,10 +22,12 @@ class PlotTrace(object):
 
 class PlotBench(object):
 
-    def __init__(self, short_name, name, x):
+    def __init__(self, short_name, name, x, x_label = 'Number of elements', legend = None):
         self.short_name = short_name
         self.name = name
         self.x = x
+        self.x_label = x_label
+        self.legend = legend
         self.traces = list()
 
     def add_trace(self, trace_name, values):
@@ -39,23 +41,105 @@ class PlotBench(object):
         return out
 
 
-def group_benchmarks(benchmarks : dict()):
+# user counters rendered as extra charts next to the timings, with their legend
+COUNTER_CHARTS = collections.OrderedDict([
+    ('instructions', 'Instructions per element'),
+    ('L1D_misses', 'L1D misses per element'),
+    ('LLC_misses', 'LLC misses per element'),
+    ('dTLB_misses', 'dTLB misses per element'),
+    ('branch_misses', 'Branch mispredictions per element'),
+    ('bytes_per_entry', 'Bytes allocated per entry'),
+    ('allocations_per_entry', 'Allocations per entry'),
+    ('peak_bytes', 'Peak bytes allocated'),
+    ('stalls', 'Inserts 100 times slower than the median'),
+    ('peak_ratio', 'Peak / final bytes allocated'),
+    ('footprint', 'Footprint of the map (bytes allocated)'),
+    ('bytes_per_element', 'Bytes allocated per element'),
+    ('copies_per_element', 'Copies of the values per element'),
+    ('moves_per_element', 'Moves of the values per element'),
+    ('allocations_per_call', 'Allocations per call'),
+    ('bytes_allocated', 'Bytes allocated'),
+    ('bytes_freed', 'Bytes freed'),
+    ('deallocations_per_entry', 'Deallocations per entry'),
+    ('hit_rate', 'Hits per access'),
+    ('evictions_per_access', 'Evictions per access'),
+])
+
+# latency percentiles counters (see the yoshi latency mode)
+PERCENTILES = collections.OrderedDict([
+    ('p50', 'p50_ns'),
+    ('p99', 'p99_ns'),
+    ('p99.9', 'p99.9_ns'),
+    ('max', 'max_ns'),
+])
+
+X_LABELS = {
+    'size': 'Number of elements',
+    'threads': 'Number of threads',
+}
+
+# benchmarks where the implementation is the second template parameter, the
+# value being an Action of the key type
+ACTION_BENCHMARKS = {'Insert_Erase_Random'}
+# benchmarks where the implementation is the second template parameter, after
+# the type of the values (queues)
+VALUE_BENCHMARKS = {'RoundTrip_Latency', 'Throughput'}
+
+def split_implementation(name : str, params : list):
+    """
+    Returns the implementation (hashmap) and the other template parameters
+    >>> split_implementation('Find_Random', ['int64_t', 'int64_t', 'absl::flat_hash_map', 'ZipfKeys<99>'])
+    ('absl::flat_hash_map', ['int64_t', 'int64_t', 'ZipfKeys<99>'])
+    >>> split_implementation('Insert_Erase_Random', ['int64_t', 'QHash'])
+    ('QHash', ['int64_t', 'Action<int64_t>'])
+    >>> split_implementation('Throughput', ['int64_t', 'yoshi::SpscRing'])
+    ('yoshi::SpscRing', ['int64_t'])
+    """
+    if name in ACTION_BENCHMARKS:
+        return params[1], [params[0], 'Action<' + params[0] + '>'] + params[2:]
+    if name in VALUE_BENCHMARKS:
+        return params[1], [params[0]] + params[2:]
+    return params[2], params[0:2] + params[3:]
+
+def group_benchmarks(benchmarks : dict(), config : dict()):
     data = collections.OrderedDict()
     for _, benchmark in benchmarks.items():
-        x_values = [b.size for b in benchmark]
-        y_values = [b.value() for b in benchmark]
-        params = benchmark[0].t_params
-        plot_key = benchmark[0].name
-        short_name = benchmark[0].name
-        if len(params) == 3:
-            line_name = params[2] + '<' + params[0] + ', ' + params[1] + '>'
-            plot_key += '<' + params[0] + ', ' + params[1] + '>'
-        else:
-            line_name = params[1] + '<' + params[0] + ', Action<' + params[0] + '>>'
-            plot_key += '<' + params[0] + ', Action<' + params[0] + '>>'
-        if not plot_key in data.keys():
-            data[plot_key] = PlotBench(short_name, plot_key, x_values)
-        data[plot_key].add_trace(line_name, y_values)
+        description = config.get(benchmark[0].name)
+        x_axis = description.x_axis if description is not None else 'size'
+        counter = description.value if description is not None else None
+        # one plot per extra arguments, and per size when it is not the x axis
+        series = collections.OrderedDict()
+        for b in benchmark:
+            key = tuple(b.args) if x_axis == 'size' else tuple([b.size] + b.args)
+            series.setdefault(key, list()).append(b)
+        for key, runs in series.items():
+            x_values = [b.size if x_axis == 'size' else getattr(b, x_axis) for b in runs]
+            y_values = [b.value(counter) for b in runs]
+            line_name, types = split_implementation(runs[0].name, runs[0].t_params)
+            plot_key = runs[0].name + '<' + ', '.join(types) + '>'
+            short_name = runs[0].name
+            line_name += '<' + ', '.join(types[0:2]) + '>'
+            plot_key += ''.join('/' + str(k) for k in key)
+            if not plot_key in data.keys():
+                data[plot_key] = PlotBench(short_name, plot_key, x_values, X_LABELS[x_axis])
+            data[plot_key].add_trace(line_name, y_values)
+            for c, legend in COUNTER_CHARTS.items():
+                # the counter plotted as the value of the benchmark
+                if c == counter or not all(c in b.counters for b in runs):
+                    continue
+                counter_key = plot_key + ' - ' + c
+                if not counter_key in data.keys():
+                    data[counter_key] = PlotBench(short_name, counter_key, x_values, X_LABELS[x_axis], legend)
+                data[counter_key].add_trace(line_name, [b.value(c) for b in runs])
+            # latency percentiles of the largest run
+            last = runs[-1]
+            if all(c in last.counters for c in PERCENTILES.values()):
+                percentile_key = plot_key + ' - percentiles'
+                if not percentile_key in data.keys():
+                    data[percentile_key] = PlotBench(short_name, percentile_key, list(PERCENTILES.keys()),
+                        'Percentile', 'Nanoseconds per operation')
+                data[percentile_key].add_trace(line_name + '/' + str(last.size),
+                    [last.value(c) for c in PERCENTILES.values()])
     return data
 
 
@@ -80,7 +164,7 @@ if __name__ == '__main__':
         data = json.load(sys.stdin)
         benchmarks = parse_benchmark_json(data)
 
-    plot_data = group_benchmarks(benchmarks)
+    plot_data = group_benchmarks(benchmarks, config)
 
     t = jinja2.Template(ht.template)
     html = t.render(benchmarks=plot_data, config=config)
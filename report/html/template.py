@@ -65,14 +65,16 @@ template="""
                         display: true,
                         scaleLabel: {
                             display: true,
-                            labelString: 'Number of elements'
+                            labelString: '{{ b.x_label }}'
                         }
                     }],
                     yAxes: [{
                         display: true,
                         scaleLabel: {
                             display: true,
-                            {% if b.short_name in config.keys() and config[b.short_name].legend is not none %}
+                            {% if b.legend is not none %}
+                                labelString: '{{b.legend}}'
+                            {% elif b.short_name in config.keys() and config[b.short_name].legend is not none %}
                                 labelString: '{{config[b.short_name].legend}}'
                             {% else %}
                                 labelString: 'Nanos per operation'
@@ -1,16 +1,82 @@
 import json
 
+# keys of a google benchmark json run which are not user counters
+RUN_KEYS = {
+    'name', 'run_name', 'run_type', 'family_index', 'per_family_instance_index',
+    'repetitions', 'repetition_index', 'threads', 'iterations', 'real_time',
+    'cpu_time', 'time_unit', 'aggregate_name', 'aggregate_unit', 'label',
+    'error_occurred', 'error_message'
+}
+
+def template_end(name: str):
+    """
+    Returns the index of the '>' closing the first template parameter list
+    >>> template_end('Find_Random<int64_t, Blob<8>, std::unordered_map>/1000')
+    48
+    """
+    depth = 0
+    for i, c in enumerate(name):
+        if c == '<':
+            depth += 1
+        elif c == '>':
+            depth -= 1
+            if depth == 0:
+                return i
+    return -1
+
+def split_template_params(params: str):
+    """
+    Splits template parameters on the top-level commas
+    >>> split_template_params('int64_t, Blob<8>, WithAllocator<std::unordered_map, ArenaAllocator>::type')
+    ['int64_t', 'Blob<8>', 'WithAllocator<std::unordered_map, ArenaAllocator>::type']
+    """
+    result = list()
+    depth = 0
+    current = ''
+    for c in params:
+        if c == ',' and depth == 0:
+            result.append(current.strip())
+            current = ''
+            continue
+        if c == '<':
+            depth += 1
+        elif c == '>':
+            depth -= 1
+        current += c
+    result.append(current.strip())
+    return result
+
 def parse_benchmark_name(name: str):
     """
     Parses a template benchmark name with a size
     >>> parse_benchmark_name('BM_Insert_Random<int64_t, int64_t, std::unordered_map>/1000')
     ('BM_Insert_Random', ['int64_t', 'int64_t', 'std::unordered_map'], 1000)
+    >>> parse_benchmark_name('Concurrent_Mixed<int64_t, int64_t, absl_sharded_map>/1000/99/real_time/threads:4')
+    ('Concurrent_Mixed', ['int64_t', 'int64_t', 'absl_sharded_map'], 1000)
     """
     base_name = name[0 : name.find('<')]
-    t_params = [ x.strip() for x in name[name.find('<') + 1 : name.find('>')].split(',')]
-    size = int(name[name.find('/') + 1:])
+    end = template_end(name)
+    t_params = split_template_params(name[name.find('<') + 1 : end])
+    args, _ = parse_benchmark_args(name)
+
+    return base_name, t_params, args[0]
 
-    return base_name, t_params, size
+def parse_benchmark_args(name: str):
+    """
+    Returns the numeric arguments of the benchmark and the number of threads
+    >>> parse_benchmark_args('BM_Insert_Random<int64_t, int64_t, std::unordered_map>/1000')
+    ([1000], 1)
+    >>> parse_benchmark_args('Concurrent_Mixed<int64_t, int64_t, absl_sharded_map>/1000/99/real_time/threads:4')
+    ([1000, 99], 4)
+    """
+    args = list()
+    threads = 1
+    for part in name[template_end(name) + 1:].split('/'):
+        if part.isdigit():
+            args.append(int(part))
+        elif part.startswith('threads:'):
+            threads = int(part[len('threads:'):])
+    return args, threads
 
 def parse_benchmark_full_name(name: str):
     """
@@ -18,7 +84,28 @@ def parse_benchmark_full_name(name: str):
     >>> parse_benchmark_full_name('BM_Insert_Random<int64_t, int64_t, std::unordered_map>/1000')
     'BM_Insert_Random<int64_t, int64_t, std::unordered_map>'
     """
-    return name[0: name.find('/')]
+    return name[0: template_end(name) + 1]
+
+def measured_time(dct: dict):
+    """
+    Returns the time measured by a json run: the manual time of the batched
+    benchmarks (reported as the real time), else the cpu time
+    >>> measured_time({'name': 'Find_Miss<int64_t, int64_t, QHash>/1000/manual_time', 'real_time': 1.0, 'cpu_time': 2.0})
+    1.0
+    >>> measured_time({'name': 'Hash_Latency<std::hash, int64_t>/1024', 'real_time': 1.0, 'cpu_time': 2.0})
+    2.0
+    """
+    if '/manual_time' in dct['name']:
+        return dct['real_time']
+    return dct['cpu_time']
+
+def parse_counters(dct: dict):
+    """
+    Returns the user counters of a json run
+    >>> parse_counters({'name': 'a', 'cpu_time': 1.0, 'items_per_second': 2.0})
+    {'items_per_second': 2.0}
+    """
+    return {k: v for k, v in dct.items() if k not in RUN_KEYS and isinstance(v, (int, float))}
 
 class Benchmark(object):
     """
@@ -29,6 +116,9 @@ class Benchmark(object):
     def __init__(self, benchmark_name, iterations, real_time, cpu_time, unit):
         self.name, self.t_params, self.size = parse_benchmark_name(benchmark_name)
         self.full_name = parse_benchmark_full_name(benchmark_name)
+        all_args, self.threads = parse_benchmark_args(benchmark_name)
+        self.args = all_args[1:]
+        self.counters = dict()
         self.iterations = iterations
         self.real_time = real_time
         self.cpu_times = [cpu_time]
@@ -43,7 +133,9 @@ class Benchmark(object):
                 (self.name, str(self.t_params), self.size, self.iterations, self.real_time, \
                  self.cpu_times[0], self.unit)
 
-    def value(self):
+    def value(self, counter = None):
+        if counter is not None:
+            return self.counters.get(counter)
         if self.name.find('Rehash') != -1:
             if self.median is None:
                 return self.cpu_times[0]
@@ -61,6 +153,14 @@ class Benchmark(object):
         else:
             return 'Nanoseconds/element'
 
+    @staticmethod
+    def reset():
+        """
+        Forgets the benchmarks parsed so far: the repetitions of the next runs
+        parsed are not merged with theirs (see parser.store)
+        """
+        Benchmark.__all_benchmarks.clear()
+
     @staticmethod
     def from_json(dct: dict):
         """
@@ -87,8 +187,9 @@ class Benchmark(object):
                 dct['run_name'],
                 dct['iterations'],
                 dct['real_time'],
-                dct['cpu_time'],
+                measured_time(dct),
                 dct['time_unit'])
+            b.counters = parse_counters(dct)
             Benchmark.__all_benchmarks[b.run_name] = b
             return b
         else:
@@ -101,22 +202,23 @@ class Benchmark(object):
                         dct['run_name'],
                         dct['iterations'],
                         dct['real_time'],
-                        dct['cpu_time'],
+                        measured_time(dct),
                         dct['time_unit'])
+                    b.counters = parse_counters(dct)
                     Benchmark.__all_benchmarks[b.run_name] = b
                     return b
                 else:
-                    Benchmark.__all_benchmarks[dct['run_name']].cpu_times.append(dct['cpu_time'])
+                    Benchmark.__all_benchmarks[dct['run_name']].cpu_times.append(measured_time(dct))
             elif dct['run_type'] == 'aggregate':
                 assert(dct['run_name'] in Benchmark.__all_benchmarks.keys())
                 b = Benchmark.__all_benchmarks[dct['run_name']]
                 aggregate_type = dct['aggregate_name']
                 if aggregate_type == 'mean':
-                    b.mean = dct['cpu_time']
+                    b.mean = measured_time(dct)
                     b.iteration = dct['iterations']
                 elif aggregate_type == 'median':
-                    b.median = dct['cpu_time']
+                    b.median = measured_time(dct)
                 elif aggregate_type == 'stddev':
-                    b.stddev = dct['cpu_time']
+                    b.stddev = measured_time(dct)
         return None
 
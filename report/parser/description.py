@@ -11,6 +11,10 @@ class Description(object):
         self.description = None
         self.details = None
         self.legend = None
+        # x axis of the plots: 'size' (first argument) or 'threads'
+        self.x_axis = 'size'
+        # user counter to plot instead of the time per element
+        self.value = None
 
         if 'description' in kwargs.keys():
             self.description = kwargs['description']
@@ -18,6 +22,10 @@ class Description(object):
             self.details = kwargs['details']
         if 'legend' in kwargs.keys():
             self.legend = kwargs['legend']
+        if 'x_axis' in kwargs.keys():
+            self.x_axis = kwargs['x_axis']
+        if 'value' in kwargs.keys():
+            self.value = kwargs['value']
 
     def __str__(self):
         return '{ ' + self.name + ': ' + self.description + '}'
@@ -0,0 +1,137 @@
+try:
+    from parser.benchmark import Benchmark
+    from parser.parser import parse_benchmark_json
+    from parser.significance import mann_whitney
+except:
+    from benchmark import Benchmark
+    from parser import parse_benchmark_json
+    from significance import mann_whitney
+
+import json
+import math
+import subprocess
+
+# results store: one json record per line, appended for each run
+#   {"sha": ..., "compiler": ..., "cpu": ..., "date": ..., "host": ...,
+#    "context": <google benchmark context>, "benchmarks": <google benchmark runs>}
+# the compiler and the cpu model are added to the context by the yoshi binaries
+
+def git_sha():
+    """
+    Returns the commit of the working directory, 'unknown' out of a git repository
+    """
+    try:
+        return subprocess.check_output(['git', 'rev-parse', 'HEAD'], stderr=subprocess.DEVNULL).decode().strip()
+    except (OSError, subprocess.CalledProcessError):
+        return 'unknown'
+
+def make_record(data: dict, sha: str):
+    """
+    Returns the record of a google benchmark json output built from the commit sha
+    >>> r = make_record({'context': {'compiler': 'gcc 12', 'cpu_model': 'Xeon', 'date': 'today'}, 'benchmarks': []}, 'abc')
+    >>> record_key(r)
+    'abc gcc 12 / Xeon (today)'
+    """
+    context = data.get('context', dict())
+    return {
+        'sha': sha,
+        'compiler': context.get('compiler', 'unknown'),
+        'cpu': context.get('cpu_model', 'unknown'),
+        'date': context.get('date', ''),
+        'host': context.get('host_name', ''),
+        'context': context,
+        'benchmarks': data['benchmarks'],
+    }
+
+def record_key(record: dict):
+    return '%s %s / %s (%s)' % (record['sha'][:12], record['compiler'], record['cpu'], record['date'])
+
+def append_record(path: str, record: dict):
+    with open(path, 'a') as f:
+        f.write(json.dumps(record, sort_keys=True) + '\n')
+
+def load_records(path: str):
+    with open(path, 'r') as f:
+        return [json.loads(line) for line in f if line.strip()]
+
+def select_record(records: list, ref: str):
+    """
+    Returns the record at the index ref (-1 being the last one) or the last
+    record whose commit starts with ref
+    >>> records = [{'sha': 'abc1'}, {'sha': 'def2'}, {'sha': 'abc3'}]
+    >>> select_record(records, '-1')['sha'], select_record(records, '0')['sha'], select_record(records, 'abc')['sha']
+    ('abc3', 'abc1', 'abc3')
+    >>> select_record(records, 'fff')
+    Traceback (most recent call last):
+    ...
+    KeyError: 'no run matches fff'
+    """
+    try:
+        return records[int(ref)]
+    except (ValueError, IndexError):
+        pass
+    for record in reversed(records):
+        if record['sha'].startswith(ref):
+            return record
+    raise KeyError('no run matches ' + ref)
+
+def parse_run(data: dict):
+    """
+    Returns the benchmarks of one run by their run name, the repetitions of
+    each one being in its cpu_times
+    """
+    Benchmark.reset()
+    runs = dict()
+    for benchmarks in parse_benchmark_json(data).values():
+        for b in benchmarks:
+            runs[b.run_name] = b
+    return runs
+
+def median(values: list):
+    """
+    >>> median([3, 1, 2]), median([4, 1, 2, 3])
+    (2, 2.5)
+    """
+    s = sorted(values)
+    middle = len(s) // 2
+    return s[middle] if len(s) % 2 else (s[middle - 1] + s[middle]) / 2
+
+class Comparison(object):
+    """
+    Timings of a benchmark in the base and the new run
+    """
+    def __init__(self, name: str, base: list, new: list):
+        self.name = name
+        self.base = median(base)
+        self.new = median(new)
+        self.change = self.new / self.base - 1 if self.base else 0.0
+        # smallest p-value the repetitions can give, 1 with a single one
+        self.best_p = 1 / math.comb(len(base) + len(new), len(new))
+        _, self.p_slower = mann_whitney(base, new)
+        _, self.p_faster = mann_whitney(new, base)
+
+    def status(self, alpha: float, threshold: float):
+        """
+        'regression' or 'improvement' when the change is significant and larger
+        than the threshold, 'repetitions' when there are too few of them to
+        conclude, else ''
+        >>> Comparison('a', [10, 11, 10, 12, 11], [13, 14, 13, 15, 14]).status(0.05, 0.05)
+        'regression'
+        >>> Comparison('a', [10, 11, 10, 12, 11], [10.1, 11, 10, 12, 11.1]).status(0.05, 0.05)
+        ''
+        >>> Comparison('a', [10], [20]).status(0.05, 0.05)
+        'repetitions'
+        """
+        if self.best_p >= alpha:
+            return 'repetitions'
+        if self.p_slower < alpha and self.change > threshold:
+            return 'regression'
+        if self.p_faster < alpha and self.change < -threshold:
+            return 'improvement'
+        return ''
+
+def compare_runs(base: dict, new: dict):
+    """
+    Returns the comparisons of the benchmarks of both runs (see parse_run)
+    """
+    return [Comparison(name, base[name].cpu_times, new[name].cpu_times) for name in base.keys() if name in new]
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+import argparse
+import json
+import os
+import re
+import sys
+
+from parser.store import (append_record, compare_runs, git_sha, load_records, make_record, parse_run,
+                          record_key, select_record)
+
+DEFAULT_STORE = 'benchmarks-results.jsonl'
+
+def load_run(store: str, ref: str):
+    """
+    Returns the google benchmark output and the key of a run, ref being a json
+    output file or a run of the store (index or commit)
+    """
+    if os.path.isfile(ref):
+        with open(ref, 'r') as f:
+            data = json.load(f)
+        return data, ref
+    record = select_record(load_records(store), ref)
+    return {'context': record['context'], 'benchmarks': record['benchmarks']}, record_key(record)
+
+def add(args):
+    for file in args.files:
+        with open(file, 'r') as f:
+            record = make_record(json.load(f), args.sha or git_sha())
+        append_record(args.store, record)
+        print('stored', record_key(record))
+    return 0
+
+def list_runs(args):
+    for i, record in enumerate(load_records(args.store)):
+        print('%3d  %s  %d runs' % (i, record_key(record), len(record['benchmarks'])))
+    return 0
+
+def compare(args):
+    base_data, base_key = load_run(args.store, args.base)
+    new_data, new_key = load_run(args.store, args.new)
+    for key in ('compiler', 'cpu_model'):
+        b, n = base_data['context'].get(key), new_data['context'].get(key)
+        if b != n:
+            print('warning: different %s: %s / %s' % (key, b, n), file=sys.stderr)
+    comparisons = compare_runs(parse_run(base_data), parse_run(new_data))
+    if args.filter:
+        comparisons = [c for c in comparisons if re.search(args.filter, c.name)]
+
+    print('base:', base_key)
+    print('new: ', new_key)
+    counts = {'regression': 0, 'improvement': 0, 'repetitions': 0}
+    for c in comparisons:
+        status = c.status(args.alpha, args.threshold)
+        if status in ('regression', 'improvement'):
+            p = c.p_slower if status == 'regression' else c.p_faster
+            print('%-12s %+7.1f%%  p=%.4f  %s  (%g -> %g)' % (status, 100 * c.change, p, c.name, c.base, c.new))
+        if status:
+            counts[status] += 1
+    print('%d benchmarks compared: %d regressions, %d improvements, %d with too few repetitions' %
+          (len(comparisons), counts['regression'], counts['improvement'], counts['repetitions']))
+    if counts['repetitions'] == len(comparisons) and comparisons:
+        print('warning: run the benchmarks with --benchmark_repetitions to compare them', file=sys.stderr)
+    return 1 if counts['regression'] else 0
+
+
+if __name__ == '__main__':
+    arg_parser = argparse.ArgumentParser(description='Stores google benchmark runs and compares them')
+    arg_parser.add_argument('-s', '--store', help='results store, one json run per line', default=DEFAULT_STORE)
+    commands = arg_parser.add_subparsers(dest='command', required=True)
+
+    add_parser = commands.add_parser('add', help='append google benchmark json outputs to the store')
+    add_parser.add_argument('-f', '--files', help='google benchmark output as a json file', default=[],
+                            action='append', required=True)
+    add_parser.add_argument('--sha', help='commit of the run, the current one by default', default='')
+    add_parser.set_defaults(run=add)
+
+    list_parser = commands.add_parser('list', help='list the stored runs')
+    list_parser.set_defaults(run=list_runs)
+
+    compare_parser = commands.add_parser('compare',
+        help='compare the repetitions of 2 runs, exits with 1 if a benchmark regressed')
+    compare_parser.add_argument('base', help='json output file, or index (-1 for the last) or commit of a stored run')
+    compare_parser.add_argument('new', help='json output file, or index or commit of a stored run')
+    compare_parser.add_argument('-a', '--alpha', help='significance level of the Mann-Whitney test',
+                                type=float, default=0.05)
+    compare_parser.add_argument('-t', '--threshold', help='smallest relative change of the median reported',
+                                type=float, default=0.05)
+    compare_parser.add_argument('-b', '--filter', help='regular expression on the benchmark names', default='')
+    compare_parser.set_defaults(run=compare)
+
+    args = arg_parser.parse_args()
+    try:
+        sys.exit(args.run(args))
+    except (KeyError, OSError) as e:
+        print('error:', e, file=sys.stderr)
+        sys.exit(2)
@@ -0,0 +1,255 @@
+#!/usr/bin/env python3
+import argparse
+import collections
+import json
+import os
+import shutil
+import subprocess
+import sys
+
+from parser.benchmark import template_end
+
+def parse_cpus(cpus: str):
+    """
+    Parses a list of CPUs like the yoshi --cpus option
+    >>> parse_cpus('0,2,8-11')
+    [0, 2, 8, 9, 10, 11]
+    >>> parse_cpus('')
+    []
+    """
+    result = list()
+    for part in filter(None, cpus.strip().split(',')):
+        first, _, last = part.partition('-')
+        result += range(int(first), int(last or first) + 1)
+    return result
+
+def read_file(path: str, default: str = ''):
+    try:
+        with open(path, 'r') as f:
+            return f.read().strip()
+    except OSError:
+        return default
+
+class Core(object):
+    """
+    Physical core: its logical CPUs (hyperthreads) and its NUMA node
+    """
+    def __init__(self, package: int, core_id: int, node: int):
+        self.package = package
+        self.core_id = core_id
+        self.node = node
+        self.cpus = list()
+        self.isolated = False
+
+    def __str__(self):
+        return 'core %d/%d (cpus %s, node %d)' % (self.package, self.core_id, ','.join(map(str, self.cpus)), self.node)
+
+def physical_cores(cpus: list):
+    """
+    Groups the CPUs by physical core, the isolated cores (isolcpus) first, then
+    alternating the NUMA nodes
+    """
+    sysfs = '/sys/devices/system/cpu/'
+    isolated = set(parse_cpus(read_file(sysfs + 'isolated')))
+    cores = collections.OrderedDict()
+    for cpu in sorted(cpus):
+        base = sysfs + 'cpu%d/' % cpu
+        package = int(read_file(base + 'topology/physical_package_id', '0'))
+        core_id = int(read_file(base + 'topology/core_id', str(cpu)))
+        nodes = [int(d[4:]) for d in os.listdir(base) if d.startswith('node') and d[4:].isdigit()] \
+            if os.path.isdir(base) else []
+        core = cores.setdefault((package, core_id), Core(package, core_id, nodes[0] if nodes else 0))
+        core.cpus.append(cpu)
+    for core in cores.values():
+        core.isolated = all(cpu in isolated for cpu in core.cpus)
+    # round robin on the nodes so the shards spread over the memory controllers
+    by_node = collections.OrderedDict()
+    for core in sorted(cores.values(), key=lambda c: not c.isolated):
+        by_node.setdefault(core.node, list()).append(core)
+    ordered = list()
+    while any(by_node.values()):
+        for node_cores in by_node.values():
+            if node_cores:
+                ordered.append(node_cores.pop(0))
+    return sorted(ordered, key=lambda c: not c.isolated)
+
+def family(name: str):
+    """
+    Returns the benchmark name without its arguments
+    >>> family('Find_Random<int64_t, int64_t, std::unordered_map>/1000/manual_time')
+    'Find_Random<int64_t, int64_t, std::unordered_map>'
+    """
+    end = template_end(name) if '<' in name else -1
+    return name[:name.find('/', end + 1)] if name.find('/', end + 1) != -1 else name
+
+def escape(name: str):
+    """
+    Escapes the characters of a benchmark name special in a regular expression
+    >>> escape('Find<int64_t, Blob<8>, HashedMap<std::unordered_map, yoshi::Wy>::type>')
+    'Find<int64_t, Blob<8>, HashedMap<std::unordered_map, yoshi::Wy>::type>'
+    >>> escape('a.b(c)*')
+    'a\\\\.b\\\\(c\\\\)\\\\*'
+    """
+    return ''.join('\\' + c if c in '.[]{}()\\*+?^$|' else c for c in name)
+
+def split_families(names: list, shards: int):
+    """
+    Splits the benchmarks by family in shards of about the same number of benchmarks
+    >>> split_families(['A<x>/1', 'A<x>/2', 'B<x>/1', 'C<x>/1'], 2)
+    [['A<x>'], ['B<x>', 'C<x>']]
+    """
+    counts = collections.OrderedDict()
+    for name in names:
+        counts[family(name)] = counts.get(family(name), 0) + 1
+    result = [list() for _ in range(shards)]
+    sizes = [0] * shards
+    for name, count in sorted(counts.items(), key=lambda item: -item[1]):
+        smallest = sizes.index(min(sizes))
+        result[smallest].append(name)
+        sizes[smallest] += count
+    for r in result:
+        r.sort(key=list(counts.keys()).index)
+    return [r for r in result if r]
+
+def shard_filter(families: list, selected: list, names: list):
+    """
+    Returns the filter running the selected benchmarks of the families: the
+    whole family when all its benchmarks are selected, else their exact names
+    >>> shard_filter(['A<x>', 'B<x>'], ['A<x>/1', 'A<x>/2', 'B<x>/1'], ['A<x>/1', 'A<x>/2', 'B<x>/1', 'B<x>/2'])
+    '^(A<x>/|B<x>/1$)'
+    """
+    patterns = list()
+    for f in families:
+        members = [n for n in selected if family(n) == f]
+        if len(members) == sum(1 for n in names if family(n) == f):
+            patterns.append(escape(f) + '/')
+        else:
+            patterns += [escape(n) + '$' for n in members]
+    return '^(' + '|'.join(patterns) + ')'
+
+def list_benchmarks(binary: str, arguments: list):
+    output = subprocess.check_output([binary] + arguments + ['--benchmark_list_tests=true'])
+    return [line for line in output.decode().splitlines() if line.strip()]
+
+class Shard(object):
+
+    def __init__(self, index: int, binary: str, filter: str, families: int = 0):
+        self.index = index
+        self.binary = binary
+        self.filter = filter
+        # 0 when the shard runs all the benchmarks of the binary
+        self.families = families
+        self.core = None
+        self.output = None
+        self.process = None
+        self.log = None
+
+    def __str__(self):
+        what = '%d families' % self.families if self.families else 'all'
+        return 'shard %d: %s (%s) on %s' % (self.index, os.path.basename(self.binary), what, self.core)
+
+def assign_cores(shards: list, cores: list):
+    """
+    Gives each shard its own physical core, and returns the warnings when there
+    are more shards than cores or when the cores are not isolated
+    """
+    warnings = list()
+    if not cores:
+        return ['no CPU available to pin the shards']
+    users = collections.defaultdict(list)
+    for shard in shards:
+        shard.core = cores[shard.index % len(cores)]
+        users[(shard.core.package, shard.core.core_id)].append(shard.index)
+    for (package, core_id), indexes in users.items():
+        if len(indexes) > 1:
+            warnings.append('shards %s share the core %d/%d, their timings disturb each other' %
+                            (', '.join(map(str, indexes)), package, core_id))
+    if not all(shard.core.isolated for shard in shards):
+        warnings.append('some cores are not isolated (isolcpus), other processes may run on them')
+    if len(set(core.node for core in cores)) > 1 and not shutil.which('numactl'):
+        warnings.append('numactl not found, the memory of the shards is not bound to their NUMA node')
+    return warnings
+
+def start(shard: Shard, arguments: list, directory: str):
+    shard.output = os.path.join(directory, 'shard_%d.json' % shard.index)
+    command = [shard.binary] + arguments + ['--benchmark_out=' + shard.output, '--benchmark_out_format=json']
+    if shard.filter:
+        command.append('--benchmark_filter=' + shard.filter)
+    cpus = shard.core.cpus
+    preexec = None
+    if shutil.which('numactl'):
+        command = ['numactl', '--membind=%d' % shard.core.node,
+                   '--physcpubind=' + ','.join(map(str, cpus))] + command
+    else:
+        preexec = lambda: os.sched_setaffinity(0, cpus)
+    shard.log = open(os.path.join(directory, 'shard_%d.log' % shard.index), 'w')
+    shard.process = subprocess.Popen(command, stdout=shard.log, stderr=subprocess.STDOUT, preexec_fn=preexec)
+
+def merge(shards: list):
+    """
+    Returns the json outputs of the shards as a single one, with the context of
+    the first shard and the shard of each run (readable by parser.load_files)
+    """
+    merged = {'context': None, 'benchmarks': list()}
+    for shard in shards:
+        with open(shard.output, 'r') as f:
+            data = json.load(f)
+        if merged['context'] is None:
+            merged['context'] = data.get('context', dict())
+            merged['context']['shards'] = list()
+        merged['context']['shards'].append({'executable': data.get('context', dict()).get('executable', shard.binary),
+                                            'cpus': shard.core.cpus, 'node': shard.core.node})
+        merged['benchmarks'] += data['benchmarks']
+    return merged
+
+
+if __name__ == '__main__':
+    arg_parser = argparse.ArgumentParser(
+        description='Runs benchmark binaries in parallel shards pinned on their own physical core and merges their '
+                    'json outputs. The arguments after -- are given to the binaries.')
+    arg_parser.add_argument('binaries', nargs='+', help='benchmark binaries, like the per implementation hashmap ones')
+    arg_parser.add_argument('-o', '--output', help='merged json output', default='benchmarks-results.json')
+    arg_parser.add_argument('-n', '--split', help='shards per binary, splitting its benchmarks by family',
+                            type=int, default=1)
+    arg_parser.add_argument('-c', '--cpus', help='CPUs given to the shards (like 0,2,8-11), all the allowed ones '
+                            'by default', default='')
+    arg_parser.add_argument('-b', '--filter', help='benchmark filter of all the shards', default='')
+    arg_parser.add_argument('-d', '--directory', help='directory of the outputs and logs of the shards',
+                            default='shards')
+    argv = sys.argv[1:]
+    arguments = argv[argv.index('--') + 1:] if '--' in argv else []
+    args = arg_parser.parse_args(argv[:argv.index('--')] if '--' in argv else argv)
+
+    shards = list()
+    for binary in args.binaries:
+        if args.split <= 1:
+            shards.append(Shard(len(shards), binary, args.filter))
+            continue
+        names = list_benchmarks(binary, arguments)
+        selected = list_benchmarks(binary, arguments + ['--benchmark_filter=' + args.filter]) if args.filter else names
+        for families in split_families(selected, args.split):
+            shards.append(Shard(len(shards), binary, shard_filter(families, selected, names), len(families)))
+
+    allowed = os.sched_getaffinity(0)
+    cpus = [c for c in parse_cpus(args.cpus) if c in allowed] if args.cpus else sorted(allowed)
+    cores = physical_cores(cpus)
+    if not cores:
+        # unpinned shards would disturb each other, their timings are not reliable
+        sys.exit('error: no CPU of --cpus is allowed to the process, the shards can not be pinned')
+    for warning in assign_cores(shards, cores):
+        print('warning:', warning, file=sys.stderr)
+    os.makedirs(args.directory, exist_ok=True)
+    for shard in shards:
+        print(shard)
+        start(shard, arguments, args.directory)
+    for shard in shards:
+        shard.process.wait()
+        shard.log.close()
+    failed = [s for s in shards if s.process.returncode != 0]
+    for shard in failed:
+        print('error: shard %d failed with %d, see %s' % (shard.index, shard.process.returncode,
+              os.path.join(args.directory, 'shard_%d.log' % shard.index)), file=sys.stderr)
+    with open(args.output, 'w') as f:
+        json.dump(merge([s for s in shards if s not in failed]), f, indent=2)
+    print('merged', len(shards) - len(failed), 'shards in', args.output)
+    sys.exit(1 if failed else 0)
@@ -0,0 +1,135 @@
+#include "affinity.hpp"
+#include "options.hpp"
+
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace yoshi {
+
+std::vector<int> parseCpus(const std::string& list)
+{
+    std::vector<int> cpus;
+    std::size_t begin = 0;
+    while (begin < list.size())
+    {
+        auto end = list.find(',', begin);
+        if (end == std::string::npos)
+        {
+            end = list.size();
+        }
+        const auto range = list.substr(begin, end - begin);
+        const auto dash = range.find('-');
+        try
+        {
+            std::size_t parsed = 0;
+            const int first = std::stoi(range, &parsed);
+            int last = first;
+            if (dash != std::string::npos and parsed == dash)
+            {
+                last = std::stoi(range.substr(dash + 1), &parsed);
+                parsed += dash + 1;
+            }
+            if (parsed != range.size() or first < 0 or last < first)
+            {
+                throw std::invalid_argument(range);
+            }
+            for (int cpu = first; cpu <= last; ++cpu)
+            {
+                cpus.push_back(cpu);
+            }
+        }
+        catch (const std::logic_error&)
+        {
+            throw std::invalid_argument("excepted a list of CPUs like 0,2,8-11, got " + list);
+        }
+        begin = end + 1;
+    }
+    return cpus;
+}
+
+const std::vector<int>& pinnedCpus()
+{
+    static const std::vector<int> s_cpus = []
+    {
+        if (not options().cpus.empty())
+        {
+            return options().cpus;
+        }
+        std::vector<int> allowed;
+#ifdef __linux__
+        cpu_set_t set;
+        if (sched_getaffinity(0, sizeof(set), &set) == 0)
+        {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            {
+                if (CPU_ISSET(cpu, &set))
+                {
+                    allowed.push_back(cpu);
+                }
+            }
+        }
+#endif
+        return allowed;
+    }();
+    return s_cpus;
+}
+
+ThreadPin::ThreadPin(std::size_t index)
+{
+    const auto& cpus = pinnedCpus();
+    if (cpus.empty())
+    {
+        static const bool s_warned = [] {
+            std::cerr << "yoshi: WARNING the threads are not pinned, their timings depend on the scheduler\n";
+            return true;
+        }();
+        (void)s_warned;
+        return;
+    }
+#ifdef __linux__
+    cpu_set_t set;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0)
+    {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        {
+            if (CPU_ISSET(cpu, &set))
+            {
+                m_previous.push_back(cpu);
+            }
+        }
+    }
+    const int cpu = cpus[index % cpus.size()];
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (const int error = pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+    {
+        throw std::system_error(error, std::generic_category(), "can not pin the thread on CPU " + std::to_string(cpu));
+    }
+    m_cpu = cpu;
+#endif
+}
+
+ThreadPin::~ThreadPin()
+{
+#ifdef __linux__
+    if (m_cpu < 0 or m_previous.empty())
+    {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (auto cpu : m_previous)
+    {
+        CPU_SET(cpu, &set);
+    }
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace yoshi {
+
+/// Parses a list of CPUs like "0,2,8-11", throws std::invalid_argument if it
+/// is not valid
+std::vector<int> parseCpus(const std::string& list);
+
+/// Returns the CPUs on which the threads are pinned: the cpus option (see
+/// yoshi::Options), else the CPUs allowed to the process when it started, so a
+/// process pinned on a core (report/run_shards.py) pins its threads on it.
+/// Empty out of linux without the option.
+const std::vector<int>& pinnedCpus();
+
+/// Pins the current thread on the `index`-th CPU of pinnedCpus (modulo their
+/// number) while it is alive, and restores the previous affinity after. Out of
+/// linux the thread is not pinned, which is reported once on the error output.
+class ThreadPin
+{
+public:
+    explicit ThreadPin(std::size_t index);
+    ~ThreadPin();
+    ThreadPin(const ThreadPin&) = delete;
+    ThreadPin& operator=(const ThreadPin&) = delete;
+
+    /// CPU of the thread, -1 if it is not pinned
+    int cpu() const { return m_cpu; }
+
+private:
+    int m_cpu = -1;
+    /// CPUs allowed before pinning
+    std::vector<int> m_previous;
+};
+
+}
@@ -0,0 +1,182 @@
+#include "allocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+
+#include <sys/mman.h>
+
+namespace yoshi {
+namespace {
+std::size_t roundUp(std::size_t size, std::size_t alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+/// Returns the index of the smallest power of 2 greater than or equal to size (> 1)
+std::size_t log2Ceil(std::size_t size)
+{
+    return 64 - __builtin_clzll(size - 1);
+}
+}
+
+Arena::Arena(bool hugePages)
+    : m_hugePages(hugePages)
+{
+}
+
+Arena::~Arena()
+{
+    for (auto& c : m_chunks)
+    {
+        release(c.p, c.size);
+    }
+}
+
+void* Arena::allocate(std::size_t size, std::size_t alignment)
+{
+    size = roundUp(size == 0 ? 1 : size, GRANULARITY);
+    if (size > LARGE_SIZE or alignment > MEDIUM_ALIGNMENT)
+    {
+        // chunks are aligned on pages which is enough for any type
+        return chunk(roundUp(size, CHUNK_SIZE));
+    }
+    void*& head = freeList(size, alignment);
+    if (head != nullptr)
+    {
+        void* p = head;
+        head = *static_cast<void**>(p);
+        return p;
+    }
+    auto current = reinterpret_cast<std::uintptr_t>(m_current);
+    auto aligned = reinterpret_cast<char*>(roundUp(current, std::max(alignment, GRANULARITY)));
+    if (m_current == nullptr or aligned + size > m_end)
+    {
+        m_current = static_cast<char*>(chunk(CHUNK_SIZE));
+        m_chunks.push_back(Chunk{m_current, CHUNK_SIZE});
+        m_end = m_current + CHUNK_SIZE;
+        aligned = m_current;
+    }
+    m_current = aligned + size;
+    return aligned;
+}
+
+void Arena::deallocate(void* p, std::size_t size, std::size_t alignment)
+{
+    size = roundUp(size == 0 ? 1 : size, GRANULARITY);
+    if (size > LARGE_SIZE or alignment > MEDIUM_ALIGNMENT)
+    {
+        release(p, roundUp(size, CHUNK_SIZE));
+        return;
+    }
+    void*& head = freeList(size, alignment);
+    *static_cast<void**>(p) = head;
+    head = p;
+}
+
+void*& Arena::freeList(std::size_t& size, std::size_t& alignment)
+{
+    if (size <= SMALL_SIZE and alignment <= GRANULARITY)
+    {
+        return m_free[size / GRANULARITY];
+    }
+    // medium blocks: one free list per power of 2, all of them aligned alike
+    const auto index = log2Ceil(size);
+    size = std::size_t(1) << index;
+    alignment = MEDIUM_ALIGNMENT;
+    return m_medium[index];
+}
+
+void* Arena::chunk(std::size_t size)
+{
+    if (not m_hugePages)
+    {
+        // through operator new so the chunks are seen by the memory tracking
+        return ::operator new(size, std::align_val_t(CHUNK_SIZE));
+    }
+    void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED)
+    {
+        return p;
+    }
+    // no huge page reserved: fallback on the transparent huge pages,
+    // over-allocating to be able to align the mapping on 2MB
+    static bool s_warned = false;
+    if (not s_warned)
+    {
+        std::cerr << "yoshi: MAP_HUGETLB failed, using madvise(MADV_HUGEPAGE)\n";
+        s_warned = true;
+    }
+    char* raw = static_cast<char*>(mmap(nullptr, size + CHUNK_SIZE, PROT_READ | PROT_WRITE,
+                                        MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+    if (raw == MAP_FAILED)
+    {
+        throw std::bad_alloc();
+    }
+    char* aligned = reinterpret_cast<char*>(roundUp(reinterpret_cast<std::uintptr_t>(raw), CHUNK_SIZE));
+    if (aligned != raw)
+    {
+        munmap(raw, aligned - raw);
+    }
+    munmap(aligned + size, raw + CHUNK_SIZE - aligned);
+    madvise(aligned, size, MADV_HUGEPAGE);
+    return aligned;
+}
+
+void Arena::release(void* p, std::size_t size)
+{
+    if (m_hugePages)
+    {
+        munmap(p, size);
+    }
+    else
+    {
+        ::operator delete(p, std::align_val_t(CHUNK_SIZE));
+    }
+}
+
+Arena& arena()
+{
+    static Arena s_arena(false);
+    return s_arena;
+}
+
+Arena& hugePageArena()
+{
+    static Arena s_arena(true);
+    return s_arena;
+}
+
+Pool::Pool(std::size_t size, std::size_t alignment)
+    : m_size(roundUp(std::max(size, sizeof(void*)), std::max(alignment, alignof(void*))))
+    , m_alignment(std::max(alignment, alignof(void*)))
+{
+}
+
+Pool::~Pool()
+{
+    for (auto slab : m_slabs)
+    {
+        ::operator delete(slab, std::align_val_t(m_alignment));
+    }
+}
+
+void Pool::refill()
+{
+    const std::size_t count = std::max<std::size_t>(1, SLAB_SIZE / m_size);
+    char* slab = static_cast<char*>(::operator new(count * m_size, std::align_val_t(m_alignment)));
+    m_slabs.push_back(slab);
+    for (std::size_t i = count; i > 0; --i)
+    {
+        deallocate(slab + (i - 1) * m_size);
+    }
+}
+
+std::pmr::memory_resource* pmrResource()
+{
+    static std::pmr::unsynchronized_pool_resource s_resource;
+    return &s_resource;
+}
+
+}
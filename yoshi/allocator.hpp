@@ -0,0 +1,226 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+/// Allocators which can be plugged in the containers to measure how much of
+/// their cost comes from the memory allocation.
+///
+/// All of them are default constructible, sharing a global memory resource, so
+/// the containers can be created the same way as with std::allocator. The
+/// resources are not thread-safe.
+namespace yoshi {
+
+/// Monotonic arena: memory is taken from big chunks which are never given back
+/// (until the end of the process). To keep the memory bounded when containers
+/// are filled and cleared in a loop, the small blocks freed are reused for the
+/// next allocations of the same size, the medium ones (bigger or more aligned)
+/// are rounded up to a power of 2 and reused for the same power, and the large
+/// ones are released.
+class Arena
+{
+public:
+    /// Creates an arena, its chunks being backed by huge pages if `hugePages`
+    explicit Arena(bool hugePages);
+    ~Arena();
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    void* allocate(std::size_t size, std::size_t alignment);
+    void deallocate(void* p, std::size_t size, std::size_t alignment);
+
+    /// Size of the chunks: a 2MB huge page
+    static constexpr std::size_t CHUNK_SIZE = 2 * 1024 * 1024;
+    /// Blocks bigger than that get their own chunk(s)
+    static constexpr std::size_t LARGE_SIZE = CHUNK_SIZE / 4;
+    /// Blocks smaller than that are reused once freed for the same size
+    static constexpr std::size_t SMALL_SIZE = 1024;
+    static constexpr std::size_t GRANULARITY = 16;
+    /// Blocks aligned on more than that get their own chunk(s)
+    static constexpr std::size_t MEDIUM_ALIGNMENT = 64;
+
+private:
+    void* chunk(std::size_t size);
+    void release(void* p, std::size_t size);
+    /// Returns the free list of the blocks of `size` and `alignment`, rounding
+    /// them to the block size and alignment of the list
+    void*& freeList(std::size_t& size, std::size_t& alignment);
+
+    bool m_hugePages;
+    char* m_current = nullptr;
+    char* m_end = nullptr;
+    struct Chunk
+    {
+        void* p;
+        std::size_t size;
+    };
+    std::vector<Chunk> m_chunks;
+    /// Free lists of the small blocks, by size / GRANULARITY
+    void* m_free[SMALL_SIZE / GRANULARITY + 1] = {};
+    /// Free lists of the medium blocks, by log2 of their size
+    void* m_medium[64] = {};
+};
+
+/// Returns the arena backed by regular memory shared by all the ArenaAllocator
+Arena& arena();
+/// Returns the arena backed by huge pages shared by all the HugePageAllocator
+Arena& hugePageArena();
+
+/// Base of the allocators using a global arena
+template <typename T, Arena& (*Source)()>
+struct ArenaAllocatorBase
+{
+    using value_type = T;
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(Source().allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        Source().deallocate(p, n * sizeof(T), alignof(T));
+    }
+};
+
+/// Allocator using the monotonic arena
+template <typename T>
+struct ArenaAllocator : ArenaAllocatorBase<T, arena>
+{
+    ArenaAllocator() = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) {}
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const { return false; }
+};
+
+/// Allocator using an arena made of 2MB huge pages (MAP_HUGETLB, or
+/// transparent huge pages with madvise if no huge page is reserved)
+template <typename T>
+struct HugePageAllocator : ArenaAllocatorBase<T, hugePageArena>
+{
+    HugePageAllocator() = default;
+    template <typename U>
+    HugePageAllocator(const HugePageAllocator<U>&) {}
+
+    template <typename U>
+    bool operator==(const HugePageAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const HugePageAllocator<U>&) const { return false; }
+};
+
+/// Pool of fixed size blocks: memory is taken from slabs and the freed blocks
+/// are kept in a free list
+class Pool
+{
+public:
+    Pool(std::size_t size, std::size_t alignment);
+    ~Pool();
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    void* allocate()
+    {
+        if (m_free == nullptr)
+        {
+            refill();
+        }
+        void* p = m_free;
+        m_free = *static_cast<void**>(p);
+        return p;
+    }
+
+    void deallocate(void* p)
+    {
+        *static_cast<void**>(p) = m_free;
+        m_free = p;
+    }
+
+    static constexpr std::size_t SLAB_SIZE = 64 * 1024;
+
+private:
+    void refill();
+
+    std::size_t m_size;
+    std::size_t m_alignment;
+    void* m_free = nullptr;
+    std::vector<void*> m_slabs;
+};
+
+/// Returns the pool of the blocks of the given size and alignment
+template <std::size_t Size, std::size_t Alignment>
+Pool& pool()
+{
+    static Pool s_pool(Size, Alignment);
+    return s_pool;
+}
+
+/// Allocator taking the single objects (the nodes of the node based containers)
+/// from a pool of fixed size blocks, arrays (buckets, flat tables) being
+/// allocated with operator new
+template <typename T>
+struct PoolAllocator
+{
+    using value_type = T;
+
+    PoolAllocator() = default;
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>&) {}
+
+    T* allocate(std::size_t n)
+    {
+        if (n == 1)
+        {
+            return static_cast<T*>(pool<sizeof(T), alignof(T)>().allocate());
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        if (n == 1)
+        {
+            pool<sizeof(T), alignof(T)>().deallocate(p);
+            return;
+        }
+        ::operator delete(p, std::align_val_t(alignof(T)));
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>&) const { return false; }
+};
+
+/// Returns the std::pmr::unsynchronized_pool_resource used by the PmrAllocator
+std::pmr::memory_resource* pmrResource();
+
+/// std::pmr::polymorphic_allocator using by default a pool resource
+/// instead of the new/delete resource
+template <typename T>
+struct PmrAllocator : std::pmr::polymorphic_allocator<T>
+{
+    PmrAllocator()
+        : std::pmr::polymorphic_allocator<T>(pmrResource())
+    {
+    }
+
+    template <typename U>
+    PmrAllocator(const PmrAllocator<U>& other)
+        : std::pmr::polymorphic_allocator<T>(other.resource())
+    {
+    }
+
+    /// The copies of the containers keep using the pool resource
+    PmrAllocator select_on_container_copy_construction() const
+    {
+        return *this;
+    }
+};
+
+}
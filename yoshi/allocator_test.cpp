@@ -0,0 +1,62 @@
+#include "allocator.hpp"
+#include "memory.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+/// Grows a table through the arena like a hashmap does, from 1KB to 1MB with
+/// sizes which are not powers of 2 and both alignments of the tables, frees
+/// it, and frees a batch of nodes allocated meanwhile
+void growAndFree(yoshi::Arena& arena)
+{
+    void* table = nullptr;
+    std::size_t tableSize = 0;
+    std::vector<void*> nodes;
+    for (std::size_t size = 1000; size <= 1000000; size = size * 2 + 24)
+    {
+        const std::size_t alignment = size % 3 == 0 ? 64 : 16;
+        void* grown = arena.allocate(size, alignment);
+        if (table != nullptr)
+        {
+            arena.deallocate(table, tableSize, tableSize % 3 == 0 ? 64 : 16);
+        }
+        table = grown;
+        tableSize = size;
+        for (int i = 0; i < 100; ++i)
+        {
+            nodes.push_back(arena.allocate(48, 8));
+        }
+    }
+    arena.deallocate(table, tableSize, tableSize % 3 == 0 ? 64 : 16);
+    for (void* node : nodes)
+    {
+        arena.deallocate(node, 48, 8);
+    }
+}
+
+}
+
+/// Checks that the memory of an arena allocating and freeing in a loop stays
+/// bounded: after the first round the freed blocks are enough for the next ones
+int main()
+{
+    yoshi::Arena arena(false);
+    yoshi::memory::Scope scope;
+    growAndFree(arena);
+    const std::int64_t first = yoshi::memory::stats().peak;
+    for (int round = 0; round < 1000; ++round)
+    {
+        growAndFree(arena);
+    }
+    const std::int64_t last = yoshi::memory::stats().peak;
+    if (last != first)
+    {
+        std::cerr << "excepted a peak of " << first << " bytes after 1000 rounds, got " << last << "\n";
+        return 1;
+    }
+    std::cout << "arena peak of " << first << " bytes after 1000 rounds\n";
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "context.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <fstream>
+
+namespace yoshi {
+
+std::string compiler()
+{
+#if defined(__clang__)
+    return "clang " __clang_version__;
+#elif defined(__GNUC__)
+    return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_FULL_VER);
+#else
+    return "unknown";
+#endif
+}
+
+std::string cpuModel()
+{
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line))
+    {
+        // "model name	: Intel(R) Xeon(R) ..."
+        if (line.rfind("model name", 0) == 0)
+        {
+            const auto colon = line.find(':');
+            if (colon != std::string::npos and colon + 2 <= line.size())
+            {
+                return line.substr(colon + 2);
+            }
+        }
+    }
+    return "unknown";
+}
+
+void addContext()
+{
+    benchmark::AddCustomContext("compiler", compiler());
+    benchmark::AddCustomContext("cpu_model", cpuModel());
+}
+
+}
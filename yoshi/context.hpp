@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+namespace yoshi {
+
+/// Name and version of the compiler which built the benchmarks
+std::string compiler();
+
+/// Model name of the CPU, "unknown" out of linux
+std::string cpuModel();
+
+/// Adds the compiler and the CPU model to the context of the google benchmark
+/// output, to key the runs in the results store (see report/results_store.py)
+void addContext();
+
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "options.hpp"
+#include "perf_counters.hpp"
+#include "yoshi.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/// Batched benchmarks: instead of pausing the timing at each iteration to build
+/// the container, a batch of independent instances (container and dataset) is
+/// built out of the timing and only the operations on all of them are timed,
+/// reported with the manual time of google benchmark.
+namespace yoshi {
+
+/// Minimum number of operations timed at once, and maximum number of instances
+constexpr std::int64_t BATCH_OPERATIONS = 1 << 16;
+constexpr std::int64_t BATCH_INSTANCES = 64;
+
+/// Number of instances of a batch when each one does `operations` operations
+inline std::int64_t batchInstances(std::int64_t operations)
+{
+    return std::clamp<std::int64_t>(BATCH_OPERATIONS / std::max<std::int64_t>(operations, 1),
+                                    1, BATCH_INSTANCES);
+}
+
+/// Returns a configure function applying `configure` (by default one Arg per
+/// size) and the manual time, required by the batched benchmarks
+inline internal::Benchmark::Configure manualTime(internal::Benchmark::Configure configure = {})
+{
+    return [configure](benchmark::internal::Benchmark* b, const std::vector<int64_t>& sizes)
+    {
+        if (configure)
+        {
+            configure(b, sizes);
+        }
+        else
+        {
+            for (auto size : sizes)
+            {
+                b->Arg(size);
+            }
+        }
+        b->UseManualTime();
+    };
+}
+
+/// Runs the iterations of the benchmark by batches of instances, each one doing
+/// `operations` operations:
+/// - setup(instance) builds every instance of the batch, out of the timing
+/// - run(instance) is called on the instances in a row, the only timed region
+///   (and the one of the performance counters). A run taking a second argument
+///   gets std::true_type in the latency mode, else std::false_type, to give to
+///   yoshi::latency::record: the mode is read once, not for each operation.
+/// - check(instance) validates the result of every instance, out of the timing
+/// One iteration is one instance, the instances are kept from one batch to the
+/// next one so setup can reuse their memory.
+template <typename Instance, typename Setup, typename Run, typename Check>
+void runBatched(benchmark::State& state, std::int64_t operations, Setup&& setup, Run&& run, Check&& check)
+{
+    if constexpr (std::is_invocable_v<Run&, Instance&, std::true_type>)
+    {
+        if (options().latency)
+        {
+            runBatched<Instance>(state, operations, setup,
+                                 [&](Instance& instance) { run(instance, std::true_type()); }, check);
+        }
+        else
+        {
+            runBatched<Instance>(state, operations, setup,
+                                 [&](Instance& instance) { run(instance, std::false_type()); }, check);
+        }
+    }
+    else
+    {
+        const auto count = batchInstances(operations);
+        std::vector<Instance> instances(count);
+        while (state.KeepRunningBatch(count))
+        {
+            for (auto& instance : instances)
+            {
+                setup(instance);
+            }
+            PerfCounters::instance().start();
+            const auto begin = std::chrono::steady_clock::now();
+            for (auto& instance : instances)
+            {
+                run(instance);
+            }
+            const auto end = std::chrono::steady_clock::now();
+            PerfCounters::instance().stop();
+            state.SetIterationTime(std::chrono::duration<double>(end - begin).count());
+            for (auto& instance : instances)
+            {
+                check(instance);
+            }
+        }
+    }
+}
+
+/// Runs `instances` instances like runBatched, by batches of
+/// batchInstances(operations) timed one after the other, and reports them as
+/// one batch of google benchmark, to be pinned to one iteration. For the
+/// operations much cheaper than the setup of their instance, whose number is
+/// then chosen from their size and not from the time of the operation.
+template <typename Instance, typename Setup, typename Run, typename Check>
+void runInstances(benchmark::State& state, std::int64_t instances, std::int64_t operations,
+                  Setup&& setup, Run&& run, Check&& check)
+{
+    std::vector<Instance> batch(std::min(batchInstances(operations), instances));
+    while (state.KeepRunningBatch(instances))
+    {
+        double seconds = 0;
+        for (std::int64_t done = 0; done < instances; done += batch.size())
+        {
+            const auto end = batch.begin() + std::min<std::int64_t>(batch.size(), instances - done);
+            std::for_each(batch.begin(), end, setup);
+            PerfCounters::instance().start();
+            const auto begin = std::chrono::steady_clock::now();
+            std::for_each(batch.begin(), end, run);
+            const auto stop = std::chrono::steady_clock::now();
+            PerfCounters::instance().stop();
+            seconds += std::chrono::duration<double>(stop - begin).count();
+            std::for_each(batch.begin(), end, check);
+        }
+        state.SetIterationTime(seconds);
+    }
+}
+
+}
@@ -0,0 +1,5 @@
+#include "tests.hpp"
+
+#include <absl/hash/hash.h>
+
+DECLARE_HASH_TESTS(absl::Hash)
@@ -0,0 +1,5 @@
+#include "tests.hpp"
+
+#include "folly/hash/Hash.h"
+
+DECLARE_HASH_TESTS(folly::hasher)
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+#if defined(__SSE4_2__)
+#include <nmmintrin.h>
+#endif
+
+/// Hash functions owned by yoshi, usable as the hasher of the hashmaps:
+/// `Hasher<K>` for the integer and the string keys.
+namespace yoshi {
+namespace hash {
+
+inline std::uint64_t read8(const char* p)
+{
+    std::uint64_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline std::uint64_t read4(const char* p)
+{
+    std::uint32_t v;
+    std::memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/// 64x64 -> 128 bits multiplication, folded
+inline std::uint64_t wymix(std::uint64_t a, std::uint64_t b)
+{
+    const __uint128_t r = static_cast<__uint128_t>(a) * b;
+    return static_cast<std::uint64_t>(r) ^ static_cast<std::uint64_t>(r >> 64);
+}
+
+constexpr std::uint64_t WY_SECRET[4] = {
+    0xa0761d6478bd642fULL, 0xe7037ed1a0b428dbULL, 0x8ebc6af09c88c6e3ULL, 0x589965cc75374cc3ULL};
+
+/// wyhash (https://github.com/wangyi-fudan/wyhash, public domain), final version 4
+inline std::uint64_t wyhash(const char* p, std::size_t len, std::uint64_t seed = 0)
+{
+    const auto* s = WY_SECRET;
+    seed ^= wymix(seed ^ s[0], s[1]);
+    std::uint64_t a = 0;
+    std::uint64_t b = 0;
+    if (len <= 16)
+    {
+        if (len >= 4)
+        {
+            const std::size_t shift = (len >> 3) << 2;
+            a = (read4(p) << 32) | read4(p + shift);
+            b = (read4(p + len - 4) << 32) | read4(p + len - 4 - shift);
+        }
+        else if (len > 0)
+        {
+            const auto* u = reinterpret_cast<const std::uint8_t*>(p);
+            a = (std::uint64_t(u[0]) << 16) | (std::uint64_t(u[len >> 1]) << 8) | u[len - 1];
+        }
+    }
+    else
+    {
+        std::size_t i = len;
+        if (i > 48)
+        {
+            std::uint64_t see1 = seed;
+            std::uint64_t see2 = seed;
+            do
+            {
+                seed = wymix(read8(p) ^ s[1], read8(p + 8) ^ seed);
+                see1 = wymix(read8(p + 16) ^ s[2], read8(p + 24) ^ see1);
+                see2 = wymix(read8(p + 32) ^ s[3], read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = wymix(read8(p) ^ s[1], read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+    a ^= s[1];
+    b ^= seed;
+    const __uint128_t r = static_cast<__uint128_t>(a) * b;
+    a = static_cast<std::uint64_t>(r);
+    b = static_cast<std::uint64_t>(r >> 64);
+    return wymix(a ^ s[0] ^ len, b ^ s[1]);
+}
+
+#if defined(__SSE4_2__)
+/// CRC32C of the bytes with the SSE4.2 instruction, 8 bytes at a time
+inline std::uint32_t crc32(const char* p, std::size_t len)
+{
+    std::uint64_t crc = ~std::uint32_t(0);
+    for (; len >= 8; len -= 8, p += 8)
+    {
+        crc = _mm_crc32_u64(crc, read8(p));
+    }
+    if (len > 0)
+    {
+        std::uint64_t tail = 0;
+        std::memcpy(&tail, p, len);
+        crc = _mm_crc32_u64(crc, tail);
+    }
+    return static_cast<std::uint32_t>(crc);
+}
+#endif
+
+}
+
+/// wyhash of the integers, mixed with a single multiplication
+template <typename K>
+struct WyHash
+{
+    std::size_t operator()(K k) const
+    {
+        return hash::wymix(static_cast<std::uint64_t>(k) ^ hash::WY_SECRET[0], hash::WY_SECRET[1]);
+    }
+};
+
+/// wyhash of the strings, transparent so the hashmaps can look up a std::string_view
+template <>
+struct WyHash<std::string>
+{
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view s) const { return hash::wyhash(s.data(), s.size()); }
+};
+
+template <>
+struct WyHash<std::string_view> : WyHash<std::string>
+{
+};
+
+#if defined(__SSE4_2__)
+/// CRC32C computed with the SSE4.2 instruction. The CRC only has 32 bits, they
+/// are spread over the 64 bits of the result by a multiplication.
+template <typename K>
+struct Crc32Hash
+{
+    std::size_t operator()(K k) const
+    {
+        return spread(_mm_crc32_u64(~std::uint32_t(0), static_cast<std::uint64_t>(k)));
+    }
+
+    static std::size_t spread(std::uint64_t crc) { return (crc | (crc << 32)) * 0x9E3779B97F4A7C15ULL; }
+};
+
+template <>
+struct Crc32Hash<std::string>
+{
+    using is_transparent = void;
+
+    std::size_t operator()(std::string_view s) const
+    {
+        return Crc32Hash<std::uint64_t>::spread(hash::crc32(s.data(), s.size()) ^ s.size());
+    }
+};
+
+template <>
+struct Crc32Hash<std::string_view> : Crc32Hash<std::string>
+{
+};
+#endif
+
+}
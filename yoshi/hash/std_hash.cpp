@@ -0,0 +1,5 @@
+#include "tests.hpp"
+
+#include <functional>
+
+DECLARE_HASH_TESTS(std::hash)
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "yoshi/perf_counters.hpp"
+#include "yoshi/yoshi.hpp"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+/// Generates the keys to hash: state.range(0) keys, the strings being of
+/// state.range(1) characters
+template <typename K>
+struct Keys
+{
+};
+
+template <>
+struct Keys<int64_t>
+{
+    static std::vector<int64_t> generate(const benchmark::State& state)
+    {
+        std::mt19937_64 generator(0);
+        std::vector<int64_t> keys(state.range(0));
+        for (auto& k : keys)
+        {
+            k = static_cast<int64_t>(generator());
+        }
+        return keys;
+    }
+
+    static std::size_t bytes(const benchmark::State&) { return sizeof(int64_t); }
+};
+
+template <>
+struct Keys<std::string>
+{
+    static std::vector<std::string> generate(const benchmark::State& state)
+    {
+        std::mt19937_64 generator(0);
+        std::uniform_int_distribution<int> letter('a', 'z');
+        std::vector<std::string> keys(state.range(0));
+        for (auto& k : keys)
+        {
+            k.resize(state.range(1));
+            for (auto& c : k)
+            {
+                c = static_cast<char>(letter(generator));
+            }
+        }
+        return keys;
+    }
+
+    static std::size_t bytes(const benchmark::State& state) { return state.range(1); }
+};
+
+/// Applies the arguments of the string keys: for each size the lengths of the keys
+inline void stringArgs(benchmark::internal::Benchmark* b, const std::vector<int64_t>& sizes)
+{
+    for (auto size : sizes)
+    {
+        for (int64_t length : {8, 16, 32, 64, 256})
+        {
+            b->Args({size, length});
+        }
+    }
+}
+
+/// Hashes state.range(0) keys, the hashes being independent from each other
+/// so the CPU can compute several of them at once
+template <template<typename ...> typename H, typename K>
+void Hash_Throughput(benchmark::State& state)
+{
+    const auto keys = Keys<K>::generate(state);
+    const H<K> hasher{};
+    std::size_t sink = 0;
+    yoshi::PerfCounters::instance().start();
+    for (auto _ : state)
+    {
+        for (const auto& k : keys)
+        {
+            sink += hasher(k);
+        }
+        benchmark::DoNotOptimize(sink);
+    }
+    yoshi::PerfCounters::instance().stop();
+    state.SetItemsProcessed(state.iterations() * keys.size());
+    state.SetBytesProcessed(state.iterations() * keys.size() * Keys<K>::bytes(state));
+}
+
+/// Hashes state.range(0) keys, the next key to hash depending on the previous
+/// hash so each hash waits for the previous one
+template <template<typename ...> typename H, typename K>
+void Hash_Latency(benchmark::State& state)
+{
+    const auto keys = Keys<K>::generate(state);
+    const H<K> hasher{};
+    std::size_t i = 0;
+    yoshi::PerfCounters::instance().start();
+    for (auto _ : state)
+    {
+        for (std::size_t n = 0; n < keys.size(); ++n)
+        {
+            i += 1 + (hasher(keys[i]) & 1);
+            i = i >= keys.size() ? i - keys.size() : i;
+        }
+        benchmark::DoNotOptimize(i);
+    }
+    yoshi::PerfCounters::instance().stop();
+    state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+#define DECLARE_HASH_TESTS(H) \
+    YOSHI_ADD_SHORT_BENCHMARK(Hash_Throughput, H, int64_t)                     \
+    YOSHI_ADD_SHORT_BENCHMARK(Hash_Latency, H, int64_t)                        \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(stringArgs, Hash_Throughput, H, std::string) \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(stringArgs, Hash_Latency, H, std::string)
@@ -0,0 +1,7 @@
+#include "tests.hpp"
+#include "hashers.hpp"
+
+DECLARE_HASH_TESTS(yoshi::WyHash)
+#if defined(__SSE4_2__)
+DECLARE_HASH_TESTS(yoshi::Crc32Hash)
+#endif
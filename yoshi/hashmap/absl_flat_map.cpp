@@ -1,6 +1,8 @@
 #include "tests.hpp"
 #include "traits.hpp"
 
+#include "yoshi/hash/hashers.hpp"
+
 #include <absl/container/flat_hash_map.h>
 
 
@@ -11,3 +13,5 @@ struct Traits<K,V, absl::flat_hash_map>
 };
 
 DECLARE_ALL_TESTS(absl::flat_hash_map)
+DECLARE_ALLOCATOR_TESTS(absl_flat_hash_map, absl::flat_hash_map)
+DECLARE_ALL_TESTS_WITH_HASHER(absl_flat_hash_map_wyhash, absl::flat_hash_map, yoshi::WyHash)
@@ -1,7 +1,14 @@
 #pragma once
 
+#include "traits.hpp"
+
 #include<cstdint>
 #include <string>
+#include <utility>
+
+/// Token of a key prefetched by Adapter::prefetch, for the hashmaps whose
+/// lookups do not take one
+struct NoPrehash {};
 
 /// Adapter in case hashmap implementation have different interface.
 ///
@@ -10,6 +17,9 @@
 ///
 /// Usually we are going to create the default implementation of the hashmap without
 /// specifying the hash function to use.
+///
+/// The write paths (emplace, tryEmplace, insertOrAssign, upsert, reinsert) use the
+/// method of the same name when the hashmap has it, and the closest one otherwise.
 template <typename KeyType, typename ValueType, template<typename ...> typename HashMap>
 struct Adapter
 {
@@ -17,16 +27,162 @@ struct Adapter
     using Value = ValueType;
     using C = HashMap<Key, Value>;
 
-    static auto insert(C& c, KeyType k, ValueType v) { return c.insert({k, v}).second;}
-    static auto erase(C& c, KeyType k) { return c.erase(k); }
-    static auto find(const C& c, KeyType k) { return c.find(k); }
+    static auto insert(C& c, const KeyType& k, const ValueType& v) { return c.insert({k, v}).second;}
+    /// Constructs the element in place, which may allocate it (a node) before
+    /// finding `k` is already there. Falls back on insert without emplace.
+    static bool emplace(C& c, const KeyType& k, const ValueType& v)
+    {
+        if constexpr (HasEmplace<C, KeyType, ValueType>::value)
+        {
+            return c.emplace(k, v).second;
+        }
+        else
+        {
+            return insert(c, k, v);
+        }
+    }
+    /// Constructs the element only if `k` is not there. Falls back on emplace
+    /// without try_emplace.
+    static bool tryEmplace(C& c, const KeyType& k, const ValueType& v)
+    {
+        if constexpr (HasTryEmplace<C, KeyType, ValueType>::value)
+        {
+            return c.try_emplace(k, v).second;
+        }
+        else
+        {
+            return emplace(c, k, v);
+        }
+    }
+    /// Inserts `k` or sets its value, returns true if it was inserted. Falls
+    /// back on update then insert without insert_or_assign.
+    static bool insertOrAssign(C& c, const KeyType& k, const ValueType& v)
+    {
+        if constexpr (HasInsertOrAssign<C, KeyType, ValueType>::value)
+        {
+            return c.insert_or_assign(k, v).second;
+        }
+        else
+        {
+            return not update(c, k, v) and insert(c, k, v);
+        }
+    }
+    /// Inserts `k` or sets its value with operator[], which default constructs
+    /// the value of a new key before assigning it
+    static void upsert(C& c, const KeyType& k, const ValueType& v) { c[k] = v; }
+    /// Sets the value of `k` by extracting its node and inserting it back, the
+    /// node is reused instead of allocated. The hashmaps without usable node
+    /// handles (see HasNodeHandle) erase then insert `k`. Returns true if `k`
+    /// was not in the hashmap.
+    static bool reinsert(C& c, const KeyType& k, const ValueType& v)
+    {
+        if constexpr (HasNodeHandle<C, KeyType>::value)
+        {
+            auto node = c.extract(k);
+            if (node.empty())
+            {
+                return insert(c, k, v);
+            }
+            node.mapped() = v;
+            c.insert(std::move(node));
+            return false;
+        }
+        else
+        {
+            const bool inserted = c.erase(k) == 0;
+            insert(c, k, v);
+            return inserted;
+        }
+    }
+    static auto erase(C& c, const KeyType& k) { return c.erase(k); }
+    /// Sets the value of `k` if it is in the hashmap, else returns false
+    static bool update(C& c, const KeyType& k, const ValueType& v)
+    {
+        auto it = c.find(k);
+        if (it == c.end())
+        {
+            return false;
+        }
+        mappedValue(it) = v;
+        return true;
+    }
+    static auto find(const C& c, const KeyType& k) { return c.find(k); }
+    /// Finds `k` given as another type than the key (std::string_view for
+    /// std::string keys), without converting it if the hashmap supports the
+    /// heterogeneous lookups
+    template <typename L>
+    static auto findHeterogeneous(const C& c, const L& k)
+    {
+        if constexpr (HasHeterogeneousFind<C, L>::value)
+        {
+            return c.find(k);
+        }
+        else
+        {
+            return c.find(KeyType(k));
+        }
+    }
     static void reserve(C& c, std::size_t size) { c.reserve(size); }
     static void clear(C& c) { c.clear(); }
+    static std::size_t size(const C& c) { return c.size(); }
+    /// Number of buckets of the hashmap, which changes when it grows
+    static std::size_t bucketCount(const C& c) { return c.bucket_count(); }
     static auto begin(C& c) { return c.begin(); }
     static auto end(C& c) { return c.end(); }
     static auto unconditionalRehash(C& c) { c.rehash(0); }
+    /// Starts loading the memory where `k` is and returns the token to give to
+    /// findPrefetched: the hash of `k` for folly F14 (prehash), else nothing.
+    /// Only for the hashmaps which CanPrefetch.
+    static auto prefetch(const C& c, const KeyType& k)
+    {
+        if constexpr (HasPrehash<C, KeyType>::value)
+        {
+            return c.prehash(k);
+        }
+        else
+        {
+            c.prefetch(k);
+            return NoPrehash();
+        }
+    }
+    /// Finds `k` prefetched by prefetch, which gave `token`
+    template <typename Token>
+    static auto findPrefetched(const C& c, const Token& token, const KeyType& k)
+    {
+        if constexpr (HasPrehash<C, KeyType>::value)
+        {
+            return c.find(token, k);
+        }
+        else
+        {
+            return c.find(k);
+        }
+    }
 };
 
+/// Hashmap of the Adapter<Key, Value, HashMap>, its specialization included
+template <typename Key, typename Value, template<typename ...> typename HashMap>
+using AdaptedMap = typename Adapter<Key, Value, HashMap>::C;
+
+
+/// Hashmap HashMap<Key, Value> using the allocator template Allocator, the hasher
+/// and the equality being the default ones of the hashmap.
+///
+/// This assumes the hashmap takes the hasher, the equality and the allocator as its
+/// 3rd, 4th and 5th template parameters like std::unordered_map. Use it through an
+/// alias template to give it to the Adapter (see DECLARE_ALL_TESTS_WITH_ALLOCATOR).
+template <template<typename ...> typename HashMap, template<typename> typename Allocator,
+          typename Key, typename Value>
+using AllocatedMap = HashMap<Key, Value,
+                             typename HashMap<Key, Value>::hasher,
+                             typename HashMap<Key, Value>::key_equal,
+                             Allocator<std::pair<const Key, Value>>>;
+
+/// Hashmap HashMap<Key, Value> using the hasher Hasher<Key>, the other template
+/// parameters being the default ones of the hashmap (see DECLARE_ALL_TESTS_WITH_HASHER).
+template <template<typename ...> typename HashMap, template<typename ...> typename Hasher,
+          typename Key, typename Value>
+using HashedMap = HashMap<Key, Value, Hasher<Key>>;
 
 /// Value selection depending on the typ/tag
 ///
@@ -3,3 +3,4 @@
 #include <boost/unordered_map.hpp>
 
 DECLARE_ALL_TESTS(boost::unordered_map)
+DECLARE_ALLOCATOR_TESTS(boost_unordered_map, boost::unordered_map)
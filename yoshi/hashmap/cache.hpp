@@ -0,0 +1,253 @@
+#pragma once
+
+#include "adapter.hpp"
+#include "traits.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+/// Caches of a bounded number of entries built on any hashmap H through the
+/// Adapter, the hashmap indexing the entries stored by the cache.
+///
+/// They have the same interface:
+/// - find(k) returns a pointer on the value of `k` and marks `k` as used, or
+///   nullptr if `k` is not cached
+/// - insert(k, v) caches `k`, which must not be cached (after a miss of find),
+///   evicting an entry when the cache is full, and returns true if it evicted one
+namespace yoshi {
+
+namespace internal {
+
+inline std::size_t checkCapacity(std::size_t capacity)
+{
+    if (capacity == 0 or capacity >= std::numeric_limits<std::uint32_t>::max())
+    {
+        throw std::logic_error("excepted a cache capacity in [1, 2^32 - 1)");
+    }
+    return capacity;
+}
+
+}
+
+/// Least recently used cache: the entries are the nodes of a std::list from the
+/// most to the least recently used one, the hashmap giving the node of a key.
+/// An eviction reuses the node of the evicted entry, so a full cache does not
+/// allocate except in the hashmap.
+template <typename K, typename V, template<typename ...> typename H>
+class ListLru
+{
+    using List = std::list<std::pair<K, V>>;
+    using AdapterT = Adapter<K, typename List::iterator, H>;
+
+public:
+    explicit ListLru(std::size_t capacity)
+        : m_capacity(internal::checkCapacity(capacity))
+    {
+        AdapterT::reserve(m_map, capacity);
+    }
+
+    V* find(const K& k)
+    {
+        auto it = AdapterT::find(m_map, k);
+        if (it == AdapterT::end(m_map))
+        {
+            return nullptr;
+        }
+        const auto node = mappedValue(it);
+        m_entries.splice(m_entries.begin(), m_entries, node);
+        return &node->second;
+    }
+
+    bool insert(const K& k, const V& v)
+    {
+        const bool evict = m_size == m_capacity;
+        if (evict)
+        {
+            auto last = std::prev(m_entries.end());
+            AdapterT::erase(m_map, last->first);
+            m_entries.splice(m_entries.begin(), m_entries, last);
+            last->first = k;
+            last->second = v;
+        }
+        else
+        {
+            m_entries.emplace_front(k, v);
+            ++m_size;
+        }
+        AdapterT::insert(m_map, k, m_entries.begin());
+        return evict;
+    }
+
+    std::size_t size() const { return m_size; }
+    std::size_t capacity() const { return m_capacity; }
+
+private:
+    typename AdapterT::C m_map;
+    List m_entries;
+    std::size_t m_size = 0;
+    std::size_t m_capacity;
+};
+
+/// Least recently used cache with the entries in a vector allocated once, linked
+/// from the most to the least recently used one by their indexes (intrusive
+/// list), the hashmap giving the index of a key. The entry 0 is the head of the
+/// circular list, so linking and unlinking have no branch.
+template <typename K, typename V, template<typename ...> typename H>
+class FlatLru
+{
+    using AdapterT = Adapter<K, std::uint32_t, H>;
+
+    struct Entry
+    {
+        K key;
+        V value;
+        std::uint32_t previous;
+        std::uint32_t next;
+    };
+
+public:
+    explicit FlatLru(std::size_t capacity)
+        : m_capacity(internal::checkCapacity(capacity))
+    {
+        AdapterT::reserve(m_map, capacity);
+        m_entries.reserve(capacity + 1);
+        m_entries.push_back(Entry{K(), V(), 0, 0});
+    }
+
+    V* find(const K& k)
+    {
+        auto it = AdapterT::find(m_map, k);
+        if (it == AdapterT::end(m_map))
+        {
+            return nullptr;
+        }
+        const std::uint32_t i = mappedValue(it);
+        unlink(i);
+        pushFront(i);
+        return &m_entries[i].value;
+    }
+
+    bool insert(const K& k, const V& v)
+    {
+        const bool evict = size() == m_capacity;
+        std::uint32_t i;
+        if (evict)
+        {
+            i = m_entries[0].previous;
+            AdapterT::erase(m_map, m_entries[i].key);
+            unlink(i);
+            m_entries[i].key = k;
+            m_entries[i].value = v;
+        }
+        else
+        {
+            i = static_cast<std::uint32_t>(m_entries.size());
+            m_entries.push_back(Entry{k, v, 0, 0});
+        }
+        pushFront(i);
+        AdapterT::insert(m_map, k, i);
+        return evict;
+    }
+
+    std::size_t size() const { return m_entries.size() - 1; }
+    std::size_t capacity() const { return m_capacity; }
+
+private:
+    void unlink(std::uint32_t i)
+    {
+        auto& entry = m_entries[i];
+        m_entries[entry.previous].next = entry.next;
+        m_entries[entry.next].previous = entry.previous;
+    }
+
+    void pushFront(std::uint32_t i)
+    {
+        const auto first = m_entries[0].next;
+        m_entries[i].previous = 0;
+        m_entries[i].next = first;
+        m_entries[first].previous = i;
+        m_entries[0].next = i;
+    }
+
+    typename AdapterT::C m_map;
+    std::vector<Entry> m_entries;
+    std::size_t m_capacity;
+};
+
+/// CLOCK approximation of the least recently used cache: a hit only sets the
+/// reference bit of the entry, and the eviction moves a hand over the entries,
+/// clearing the bits set, up to an entry not used since the last pass of the
+/// hand. The bits are in their own vector so the hand scans a dense array.
+template <typename K, typename V, template<typename ...> typename H>
+class ClockCache
+{
+    using AdapterT = Adapter<K, std::uint32_t, H>;
+
+public:
+    explicit ClockCache(std::size_t capacity)
+        : m_capacity(internal::checkCapacity(capacity))
+    {
+        AdapterT::reserve(m_map, capacity);
+        m_entries.reserve(capacity);
+        m_referenced.reserve(capacity);
+    }
+
+    V* find(const K& k)
+    {
+        auto it = AdapterT::find(m_map, k);
+        if (it == AdapterT::end(m_map))
+        {
+            return nullptr;
+        }
+        const std::uint32_t i = mappedValue(it);
+        m_referenced[i] = 1;
+        return &m_entries[i].second;
+    }
+
+    bool insert(const K& k, const V& v)
+    {
+        if (m_entries.size() < m_capacity)
+        {
+            AdapterT::insert(m_map, k, static_cast<std::uint32_t>(m_entries.size()));
+            m_entries.emplace_back(k, v);
+            m_referenced.push_back(0);
+            return false;
+        }
+        while (m_referenced[m_hand])
+        {
+            m_referenced[m_hand] = 0;
+            advance();
+        }
+        auto& entry = m_entries[m_hand];
+        AdapterT::erase(m_map, entry.first);
+        entry.first = k;
+        entry.second = v;
+        AdapterT::insert(m_map, k, m_hand);
+        // the new entry gets a whole round of the hand to be used
+        advance();
+        return true;
+    }
+
+    std::size_t size() const { return m_entries.size(); }
+    std::size_t capacity() const { return m_capacity; }
+
+private:
+    void advance()
+    {
+        m_hand = m_hand + 1 == m_capacity ? 0 : m_hand + 1;
+    }
+
+    typename AdapterT::C m_map;
+    std::vector<std::pair<K, V>> m_entries;
+    std::vector<std::uint8_t> m_referenced;
+    std::uint32_t m_hand = 0;
+    std::size_t m_capacity;
+};
+
+}
@@ -0,0 +1,14 @@
+#include "concurrent_tests.hpp"
+#include "concurrent_maps.hpp"
+
+#include <absl/container/flat_hash_map.h>
+
+// use type aliases to keep the benchmark names short
+template<typename K, typename V>
+using absl_sharded_map = yoshi::ShardedMap<absl::flat_hash_map<K, V>>;
+
+template<typename K, typename V>
+using absl_rwlock_map = yoshi::RWLockMap<absl::flat_hash_map<K, V>>;
+
+DECLARE_CONCURRENT_TESTS(absl_sharded_map)
+DECLARE_CONCURRENT_TESTS(absl_rwlock_map)
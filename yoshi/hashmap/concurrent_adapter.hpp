@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+/// Adapter for the hashmaps shared between several threads.
+///
+/// The default implementation follows the interface of the yoshi concurrent
+/// wrappers (see concurrent_maps.hpp), other implementations need to partially
+/// specialize it. Every operation must be safe to call concurrently.
+template <typename KeyType, typename ValueType, template<typename ...> typename HashMap>
+struct ConcurrentAdapter
+{
+    using Key = KeyType;
+    using Value = ValueType;
+    using C = HashMap<Key, Value>;
+
+    static auto create(std::size_t size)
+    {
+        auto c = std::make_unique<C>();
+        c->reserve(size);
+        return c;
+    }
+    static bool insert(C& c, KeyType k, ValueType v) { return c.insert(k, v); }
+    static bool erase(C& c, KeyType k) { return c.erase(k); }
+    static bool contains(const C& c, KeyType k) { return c.contains(k); }
+};
@@ -0,0 +1,25 @@
+#include "concurrent_tests.hpp"
+
+#include "folly/concurrency/ConcurrentHashMap.h"
+
+// use a type alias since the ConcurrentHashMap has non-type template
+// parameters and to keep the benchmark names short
+template<typename K, typename V>
+using folly_concurrent_map = folly::ConcurrentHashMap<K, V>;
+
+/// Specialize the adapter since the folly map is sized at construction
+/// and follows the std::unordered_map interface
+template<typename KeyType, typename ValueType>
+struct ConcurrentAdapter<KeyType, ValueType, folly_concurrent_map>
+{
+    using Key = KeyType;
+    using Value = ValueType;
+    using C = folly_concurrent_map<Key, Value>;
+
+    static auto create(std::size_t size) { return std::make_unique<C>(size); }
+    static bool insert(C& c, KeyType k, ValueType v) { return c.insert(k, v).second; }
+    static bool erase(C& c, KeyType k) { return c.erase(k); }
+    static bool contains(const C& c, KeyType k) { return c.find(k) != c.cend(); }
+};
+
+DECLARE_CONCURRENT_TESTS(folly_concurrent_map)
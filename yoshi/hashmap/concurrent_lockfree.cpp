@@ -0,0 +1,4 @@
+#include "concurrent_tests.hpp"
+#include "concurrent_maps.hpp"
+
+DECLARE_CONCURRENT_TESTS(yoshi::LockFreeMap)
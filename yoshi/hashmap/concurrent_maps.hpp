@@ -0,0 +1,252 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <type_traits>
+
+namespace yoshi {
+
+/// Mixes the bits of a hash (murmur3 finalizer), used to select the shard
+/// so it does not correlate with the bucket selection of the wrapped map
+inline std::uint64_t mix(std::uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+/// Thread-safe wrapper splitting the keys over `Shards` independent maps,
+/// each of them protected by its own mutex.
+template <typename Map, std::size_t Shards = 64>
+class ShardedMap
+{
+public:
+    using key_type = typename Map::key_type;
+    using mapped_type = typename Map::mapped_type;
+
+    bool insert(const key_type& k, const mapped_type& v)
+    {
+        auto& s = shard(k);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.map.insert({k, v}).second;
+    }
+
+    bool erase(const key_type& k)
+    {
+        auto& s = shard(k);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.map.erase(k);
+    }
+
+    bool contains(const key_type& k) const
+    {
+        auto& s = shard(k);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.map.find(k) != s.map.end();
+    }
+
+    void reserve(std::size_t size)
+    {
+        for (auto& s : m_shards)
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            s.map.reserve(size / Shards + 1);
+        }
+    }
+
+private:
+    struct alignas(64) Shard
+    {
+        mutable std::mutex mutex;
+        Map map;
+    };
+
+    Shard& shard(const key_type& k) { return m_shards[index(k)]; }
+    const Shard& shard(const key_type& k) const { return m_shards[index(k)]; }
+    static std::size_t index(const key_type& k)
+    {
+        return mix(std::hash<key_type>{}(k)) % Shards;
+    }
+
+    Shard m_shards[Shards];
+};
+
+/// Thread-safe wrapper protecting a single map with a reader-writer lock:
+/// lookups share the lock, insert and erase take it exclusively.
+template <typename Map>
+class RWLockMap
+{
+public:
+    using key_type = typename Map::key_type;
+    using mapped_type = typename Map::mapped_type;
+
+    bool insert(const key_type& k, const mapped_type& v)
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        return m_map.insert({k, v}).second;
+    }
+
+    bool erase(const key_type& k)
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        return m_map.erase(k);
+    }
+
+    bool contains(const key_type& k) const
+    {
+        std::shared_lock<std::shared_mutex> lock(m_mutex);
+        return m_map.find(k) != m_map.end();
+    }
+
+    void reserve(std::size_t size)
+    {
+        std::unique_lock<std::shared_mutex> lock(m_mutex);
+        m_map.reserve(size);
+    }
+
+private:
+    mutable std::shared_mutex m_mutex;
+    Map m_map;
+};
+
+/// Lock-free open-addressing map with linear probing.
+///
+/// Keys are claimed with a CAS and never removed from their slot: erase only
+/// flips the slot state, and inserting the key again revives the same slot.
+/// The number of distinct keys ever inserted must therefore stay below the
+/// capacity given to reserve(), which must be called before sharing the map:
+/// inserting a new key in a full table throws std::length_error.
+///
+/// The largest key marks the empty slots, so it has its own slot after the
+/// table.
+template <typename K, typename V>
+class LockFreeMap
+{
+    static_assert(std::is_integral<K>::value, "LockFreeMap only supports integer keys");
+    static_assert(std::is_trivially_copyable<V>::value, "LockFreeMap values must be trivially copyable");
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+
+    bool insert(K k, V v)
+    {
+        auto* slot = claim(k);
+        std::uint32_t expected = ABSENT;
+        if (not slot->state.compare_exchange_strong(expected, WRITING, std::memory_order_acquire))
+        {
+            return false;
+        }
+        slot->value.store(v, std::memory_order_relaxed);
+        slot->state.store(PRESENT, std::memory_order_release);
+        return true;
+    }
+
+    bool erase(K k)
+    {
+        auto* slot = lookup(k);
+        if (slot == nullptr)
+        {
+            return false;
+        }
+        std::uint32_t expected = PRESENT;
+        return slot->state.compare_exchange_strong(expected, ABSENT, std::memory_order_acq_rel);
+    }
+
+    bool contains(K k) const
+    {
+        auto* slot = lookup(k);
+        return slot != nullptr and slot->state.load(std::memory_order_acquire) == PRESENT;
+    }
+
+    void reserve(std::size_t size)
+    {
+        std::size_t capacity = 16;
+        while (capacity < 2 * size)
+        {
+            capacity *= 2;
+        }
+        m_slots.reset(new Slot[capacity + 1]);
+        m_mask = capacity - 1;
+    }
+
+private:
+    static constexpr K EMPTY = std::numeric_limits<K>::max();
+    static constexpr std::uint32_t ABSENT = 0;
+    static constexpr std::uint32_t WRITING = 1;
+    static constexpr std::uint32_t PRESENT = 2;
+
+    struct Slot
+    {
+        std::atomic<K> key{EMPTY};
+        std::atomic<std::uint32_t> state{ABSENT};
+        std::atomic<V> value{};
+    };
+
+    /// Returns the slot owning `k`, claiming an empty one if needed
+    Slot* claim(K k)
+    {
+        if (k == EMPTY)
+        {
+            return &m_slots[m_mask + 1];
+        }
+        auto i = mix(k) & m_mask;
+        for (std::size_t probes = 0; probes <= m_mask; ++probes, i = (i + 1) & m_mask)
+        {
+            auto& slot = m_slots[i];
+            K current = slot.key.load(std::memory_order_acquire);
+            if (current == k)
+            {
+                return &slot;
+            }
+            if (current == EMPTY)
+            {
+                if (slot.key.compare_exchange_strong(current, k, std::memory_order_acq_rel)
+                    or current == k)
+                {
+                    return &slot;
+                }
+            }
+        }
+        throw std::length_error("yoshi::LockFreeMap: excepted less keys than the capacity");
+    }
+
+    /// Returns the slot owning `k` or nullptr if the key was never inserted
+    Slot* lookup(K k) const
+    {
+        if (k == EMPTY)
+        {
+            return &m_slots[m_mask + 1];
+        }
+        auto i = mix(k) & m_mask;
+        for (std::size_t probes = 0; probes <= m_mask; ++probes, i = (i + 1) & m_mask)
+        {
+            auto& slot = m_slots[i];
+            K current = slot.key.load(std::memory_order_acquire);
+            if (current == k)
+            {
+                return &slot;
+            }
+            if (current == EMPTY)
+            {
+                return nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+    /// The table then the slot of the key EMPTY, whose key is not used
+    std::unique_ptr<Slot[]> m_slots;
+    std::size_t m_mask = 0;
+};
+
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "adapter.hpp"
+#include "concurrent_adapter.hpp"
+
+#include "yoshi/perf_counters.hpp"
+#include "yoshi/yoshi.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+/// Number of operations done by each thread per iteration
+constexpr int64_t CONCURRENT_OPS = 8192;
+
+/// Applies the arguments of the concurrent benchmarks: for each size all the
+/// read percentages, with a number of threads going from 1 to the number of cores
+inline void concurrentArgs(benchmark::internal::Benchmark* b, const std::vector<int64_t>& sizes)
+{
+    for (auto size : sizes)
+    {
+        for (int64_t reads : {99, 90, 50})
+        {
+            b->Args({size, reads});
+        }
+    }
+    const int cores = std::max(1u, std::thread::hardware_concurrency());
+    b->ThreadRange(1, cores)->UseRealTime();
+}
+
+/// Fills a shared map with [0, state.range(0) -1] and measure the throughput of
+/// all the threads doing random operations on it, state.range(1) being the
+/// percentage of reads. Writes erase a random key and insert it back on the
+/// next write so the size of the map stays stable.
+template <typename K, typename V, template<typename ...> typename H>
+void Concurrent_Mixed(benchmark::State& state)
+{
+    using AdapterT = ConcurrentAdapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    // shared by all the threads, created and destroyed by the first one
+    static std::unique_ptr<Type> s_map;
+
+    const auto size = state.range(0);
+    const auto reads = state.range(1);
+    const auto value = ValueSelector<V>::value();
+    if (state.thread_index() == 0)
+    {
+        s_map = AdapterT::create(size);
+        for (K i = 0; i < size; ++i)
+        {
+            AdapterT::insert(*s_map, i, value);
+        }
+    }
+
+    struct Operation
+    {
+        K key;
+        bool read;
+    };
+    std::vector<Operation> operations;
+    operations.reserve(CONCURRENT_OPS);
+    std::mt19937_64 generator(state.thread_index());
+    std::uniform_int_distribution<K> keys(0, size - 1);
+    std::uniform_int_distribution<int64_t> percent(0, 99);
+    for (int64_t i = 0; i < CONCURRENT_OPS; ++i)
+    {
+        operations.push_back(Operation{keys(generator), percent(generator) < reads});
+    }
+
+    bool erased = false;
+    K pending = 0;
+    // all the threads wait for each other before starting the loop,
+    // so the map is ready at that point
+    yoshi::PerfCounters::instance().start();
+    for (auto _ : state)
+    {
+        auto& c = *s_map;
+        int64_t found = 0;
+        for (auto& op : operations)
+        {
+            if (op.read)
+            {
+                found += AdapterT::contains(c, op.key);
+            }
+            else if (erased)
+            {
+                AdapterT::insert(c, pending, value);
+                erased = false;
+            }
+            else
+            {
+                AdapterT::erase(c, op.key);
+                pending = op.key;
+                erased = true;
+            }
+        }
+        benchmark::DoNotOptimize(found);
+    }
+    yoshi::PerfCounters::instance().stop();
+    yoshi::PerfCounters::instance().setOperations(CONCURRENT_OPS);
+    state.SetItemsProcessed(state.iterations() * CONCURRENT_OPS);
+    state.counters["ops_per_thread"] = benchmark::Counter(
+        state.iterations() * CONCURRENT_OPS,
+        benchmark::Counter::kAvgThreadsRate);
+
+    // same as the start, all the threads are done once out of the loop
+    if (state.thread_index() == 0)
+    {
+        s_map.reset();
+    }
+}
+
+#define DECLARE_CONCURRENT_TESTS(C) \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(concurrentArgs, Concurrent_Mixed, int64_t, int64_t, C)
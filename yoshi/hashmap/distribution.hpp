@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+/// Key distributions used to generate the stream of keys of a benchmark.
+///
+/// A distribution is built for a key space [0, n) and then returns random keys
+/// from it. Except UniformKeys, which is a permutation of the key space, all the
+/// distributions draw keys with replacement.
+using Generator = std::mt19937_64;
+
+/// Every key exactly once in a random order (std::shuffle)
+struct UniformKeys
+{
+    static constexpr bool permutation = true;
+
+    UniformKeys(int64_t n, Generator&)
+        : m_distribution(0, n - 1)
+    {
+    }
+
+    int64_t operator()(Generator& g) { return m_distribution(g); }
+
+private:
+    std::uniform_int_distribution<int64_t> m_distribution;
+};
+
+/// Keys drawn uniformly with replacement, unlike UniformKeys a key may come
+/// back before the others were drawn
+struct RandomKeys
+{
+    static constexpr bool permutation = false;
+
+    RandomKeys(int64_t n, Generator&)
+        : m_distribution(0, n - 1)
+    {
+    }
+
+    int64_t operator()(Generator& g) { return m_distribution(g); }
+
+private:
+    std::uniform_int_distribution<int64_t> m_distribution;
+};
+
+/// Zipf distribution with the exponent S / 100: the key of rank r is drawn
+/// with a probability proportional to 1 / r^s. The ranks are spread over the
+/// key space with a random permutation so the hot keys are not adjacent.
+template <int S>
+struct ZipfKeys
+{
+    static constexpr bool permutation = false;
+
+    ZipfKeys(int64_t n, Generator& g)
+        : m_keys(n)
+        , m_cdf(n)
+    {
+        const double s = S / 100.0;
+        double sum = 0;
+        for (int64_t r = 0; r < n; ++r)
+        {
+            sum += 1.0 / std::pow(static_cast<double>(r + 1), s);
+            m_cdf[r] = sum;
+        }
+        for (auto& c : m_cdf)
+        {
+            c /= sum;
+        }
+        std::iota(m_keys.begin(), m_keys.end(), 0);
+        std::shuffle(m_keys.begin(), m_keys.end(), g);
+    }
+
+    int64_t operator()(Generator& g)
+    {
+        const auto u = m_uniform(g);
+        auto rank = std::lower_bound(m_cdf.begin(), m_cdf.end(), u) - m_cdf.begin();
+        return m_keys[std::min<int64_t>(rank, m_keys.size() - 1)];
+    }
+
+private:
+    std::vector<int64_t> m_keys;
+    std::vector<double> m_cdf;
+    std::uniform_real_distribution<double> m_uniform{0.0, 1.0};
+};
+
+/// HotPercent % of the keys (picked at random) receive HotTraffic % of the
+/// draws, the rest of the traffic goes uniformly to the cold keys
+template <int HotPercent, int HotTraffic>
+struct HotColdKeys
+{
+    static constexpr bool permutation = false;
+
+    HotColdKeys(int64_t n, Generator& g)
+        : m_keys(n)
+        , m_hot(std::max<int64_t>(1, n * HotPercent / 100))
+    {
+        std::iota(m_keys.begin(), m_keys.end(), 0);
+        std::shuffle(m_keys.begin(), m_keys.end(), g);
+    }
+
+    int64_t operator()(Generator& g)
+    {
+        const int64_t n = m_keys.size();
+        if (m_percent(g) < HotTraffic or m_hot == n)
+        {
+            return m_keys[std::uniform_int_distribution<int64_t>(0, m_hot - 1)(g)];
+        }
+        return m_keys[std::uniform_int_distribution<int64_t>(m_hot, n - 1)(g)];
+    }
+
+private:
+    std::vector<int64_t> m_keys;
+    int64_t m_hot;
+    std::uniform_int_distribution<int> m_percent{0, 99};
+};
+
+/// The traffic is concentrated on `Clusters` ranges of contiguous keys starting
+/// at random positions, each range being n / (16 * Clusters) keys wide
+template <int Clusters>
+struct ClusteredKeys
+{
+    static constexpr bool permutation = false;
+
+    ClusteredKeys(int64_t n, Generator& g)
+        : m_n(n)
+        , m_width(std::max<int64_t>(1, n / (Clusters * 16)))
+    {
+        std::uniform_int_distribution<int64_t> start(0, n - 1);
+        for (int i = 0; i < Clusters; ++i)
+        {
+            m_starts.push_back(start(g));
+        }
+    }
+
+    int64_t operator()(Generator& g)
+    {
+        const auto start = m_starts[std::uniform_int_distribution<int>(0, Clusters - 1)(g)];
+        const auto offset = std::uniform_int_distribution<int64_t>(0, m_width - 1)(g);
+        return (start + offset) % m_n;
+    }
+
+private:
+    int64_t m_n;
+    int64_t m_width;
+    std::vector<int64_t> m_starts;
+};
+
+/// Fills `keys` with `count` keys from the distribution over [0, n)
+///
+/// For the permutation distributions `count` must be equal to `n`.
+template <typename K, typename Dist>
+void generateKeys(std::vector<K>& keys, Dist& dist, int64_t n, int64_t count, Generator& g)
+{
+    keys.clear();
+    if constexpr (Dist::permutation)
+    {
+        for(K i = 0; i < n; ++i)
+        {
+            keys.push_back(i);
+        }
+        std::shuffle(keys.begin(), keys.end(), g);
+    }
+    else
+    {
+        for (int64_t i = 0; i < count; ++i)
+        {
+            keys.push_back(static_cast<K>(dist(g)));
+        }
+    }
+}
+
+/// Length distributions of the string keys, see generateStringKeys.
+/// With libstdc++ the strings of up to 15 characters are stored inline (SSO),
+/// the longer ones are allocated on the heap.
+
+/// All the keys have N characters
+template <int N>
+struct FixedLength
+{
+    static int length(Generator&) { return N; }
+};
+
+/// Lengths uniformly distributed in [Min, Max]
+template <int Min, int Max>
+struct UniformLength
+{
+    static int length(Generator& g) { return std::uniform_int_distribution<int>(Min, Max)(g); }
+};
+
+/// Generates n distinct string keys whose lengths follow the distribution
+/// Length. The first 4 characters encode the index of the key (so at least 4
+/// characters and at most 62^4 keys), the others are random.
+template <typename Length>
+std::vector<std::string> generateStringKeys(int64_t n, Generator& g)
+{
+    static const char ALPHABET[] = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    constexpr int64_t BASE = sizeof(ALPHABET) - 1;
+    std::uniform_int_distribution<int> letter(0, BASE - 1);
+    std::vector<std::string> keys;
+    keys.reserve(n);
+    for (int64_t i = 0; i < n; ++i)
+    {
+        std::string key(std::max(Length::length(g), 4), ' ');
+        auto index = i;
+        for (int d = 0; d < 4; ++d, index /= BASE)
+        {
+            key[d] = ALPHABET[index % BASE];
+        }
+        for (std::size_t c = 4; c < key.size(); ++c)
+        {
+            key[c] = ALPHABET[letter(g)];
+        }
+        keys.push_back(std::move(key));
+    }
+    return keys;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace yoshi {
+
+/// Prefix sums of an array of counters, updated and queried in O(log n)
+class FenwickTree
+{
+public:
+    /// size counters initialized to value, built in O(n)
+    explicit FenwickTree(std::size_t size, std::uint32_t value = 0)
+        : m_tree(size + 1, value)
+    {
+        m_tree[0] = 0;
+        if (value != 0)
+        {
+            for (std::size_t i = 1; i <= size; ++i)
+            {
+                m_tree[i] = static_cast<std::uint32_t>(value * (i & (~i + 1)));
+            }
+        }
+    }
+
+    void add(std::size_t index, std::int64_t delta)
+    {
+        for (++index; index < m_tree.size(); index += index & (~index + 1))
+        {
+            m_tree[index] += static_cast<std::uint32_t>(delta);
+        }
+    }
+
+    /// Sum of the count first counters
+    std::int64_t prefix(std::size_t count) const
+    {
+        std::int64_t sum = 0;
+        for (; count > 0; count &= count - 1)
+        {
+            sum += m_tree[count];
+        }
+        return sum;
+    }
+
+    /// Returns the largest count, and its prefix, such that pred(count, prefix(count))
+    /// holds, pred being true then false when count increases
+    template <typename Pred>
+    std::pair<std::size_t, std::int64_t> search(Pred&& pred) const
+    {
+        const std::size_t size = m_tree.size() - 1;
+        std::size_t step = 1;
+        while (step * 2 <= size)
+        {
+            step *= 2;
+        }
+        std::size_t count = 0;
+        std::int64_t sum = 0;
+        for (; step > 0 and size > 0; step /= 2)
+        {
+            if (count + step <= size and pred(count + step, sum + m_tree[count + step]))
+            {
+                count += step;
+                sum += m_tree[count];
+            }
+        }
+        return {count, sum};
+    }
+
+private:
+    std::vector<std::uint32_t> m_tree;
+};
+
+}
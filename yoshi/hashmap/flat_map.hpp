@@ -0,0 +1,862 @@
+#pragma once
+
+#include "flat_map_group.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace yoshi {
+namespace flat_map {
+
+/// Mixes the bits of the hash (folded 128 bits multiplication) so the hashers
+/// returning the key itself, like std::hash of the integers, spread over the table
+inline std::uint64_t mix(std::uint64_t h)
+{
+    const __uint128_t m = static_cast<__uint128_t>(h) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<std::uint64_t>(m) ^ static_cast<std::uint64_t>(m >> 64);
+}
+
+/// Control bytes of the tables without any slot: a sentinel for the iterators
+/// followed by empty bytes, so the lookups stop on the first group
+template <std::size_t Width>
+ctrl_t* emptyGroup()
+{
+    struct alignas(Width) Group
+    {
+        Group()
+        {
+            std::memset(ctrl, EMPTY, Width);
+            std::memset(ctrl + Width, SENTINEL, Width);
+            ctrl[0] = SENTINEL;
+        }
+        ctrl_t ctrl[2 * Width];
+    };
+    static Group s_group;
+    return s_group.ctrl;
+}
+
+/// operator-> of the iterators whose reference is a temporary
+template <typename Reference>
+struct ArrowProxy
+{
+    Reference reference;
+    const Reference* operator->() const { return &reference; }
+};
+
+/// Slots of the InterleavedLayout: an array of std::pair<const K, V>
+template <typename K, typename V>
+struct InterleavedSlots
+{
+    using value_type = std::pair<const K, V>;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+
+    /// Position of a slot
+    struct Cursor
+    {
+        value_type* slot = nullptr;
+
+        const K& key() const { return slot->first; }
+        V& value() const { return slot->second; }
+        reference get() const { return *slot; }
+        void advance(std::size_t n) { slot += n; }
+    };
+
+    static constexpr std::size_t ALIGNMENT = alignof(value_type);
+    static constexpr bool TRIVIALLY_DESTRUCTIBLE = std::is_trivially_destructible<value_type>::value;
+
+    static std::size_t bytes(std::size_t capacity) { return capacity * sizeof(value_type); }
+
+    static Cursor at(void* slots, std::size_t, std::size_t index)
+    {
+        return {static_cast<value_type*>(slots) + index};
+    }
+
+    template <typename Pointer, typename Reference>
+    static Pointer arrow(Reference r) { return &r; }
+
+    template <typename Key, typename... Args>
+    static void construct(Cursor c, Key&& key, Args&&... args)
+    {
+        new (c.slot) value_type(std::piecewise_construct,
+                                std::forward_as_tuple(std::forward<Key>(key)),
+                                std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    static void destroy(Cursor c) { c.slot->~value_type(); }
+
+    /// Moves the element of `from` to the free slot `to`
+    static void transfer(Cursor to, Cursor from)
+    {
+        construct(to, std::move(const_cast<K&>(from.slot->first)), std::move(from.slot->second));
+        destroy(from);
+    }
+};
+
+/// Slots of the SplitLayout: an array of keys followed by an array of values.
+/// The iterators return pairs of references, like std::flat_map
+template <typename K, typename V>
+struct SplitSlots
+{
+    using value_type = std::pair<const K, V>;
+    using reference = std::pair<const K&, V&>;
+    using const_reference = std::pair<const K&, const V&>;
+    using pointer = ArrowProxy<reference>;
+    using const_pointer = ArrowProxy<const_reference>;
+
+    struct Cursor
+    {
+        K* k = nullptr;
+        V* v = nullptr;
+
+        const K& key() const { return *k; }
+        V& value() const { return *v; }
+        reference get() const { return {*k, *v}; }
+        void advance(std::size_t n)
+        {
+            k += n;
+            v += n;
+        }
+    };
+
+    static constexpr std::size_t ALIGNMENT = alignof(K) > alignof(V) ? alignof(K) : alignof(V);
+    static constexpr bool TRIVIALLY_DESTRUCTIBLE =
+        std::is_trivially_destructible<K>::value and std::is_trivially_destructible<V>::value;
+
+    static std::size_t valuesOffset(std::size_t capacity)
+    {
+        return (capacity * sizeof(K) + alignof(V) - 1) / alignof(V) * alignof(V);
+    }
+
+    static std::size_t bytes(std::size_t capacity)
+    {
+        return valuesOffset(capacity) + capacity * sizeof(V);
+    }
+
+    static Cursor at(void* slots, std::size_t capacity, std::size_t index)
+    {
+        auto* values = static_cast<char*>(slots) + valuesOffset(capacity);
+        return {static_cast<K*>(slots) + index, reinterpret_cast<V*>(values) + index};
+    }
+
+    template <typename Pointer, typename Reference>
+    static Pointer arrow(Reference r) { return Pointer{r}; }
+
+    template <typename Key, typename... Args>
+    static void construct(Cursor c, Key&& key, Args&&... args)
+    {
+        new (c.k) K(std::forward<Key>(key));
+        try
+        {
+            new (c.v) V(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            c.k->~K();
+            throw;
+        }
+    }
+
+    static void destroy(Cursor c)
+    {
+        c.k->~K();
+        c.v->~V();
+    }
+
+    static void transfer(Cursor to, Cursor from)
+    {
+        construct(to, std::move(*from.k), std::move(*from.v));
+        destroy(from);
+    }
+};
+
+}
+
+/// The pairs key/value are next to each other: a hit touches a single cache line
+struct InterleavedLayout
+{
+    template <typename K, typename V>
+    using Slots = flat_map::InterleavedSlots<K, V>;
+};
+
+/// The keys and the values are in separate arrays: more keys fit in the cache
+/// lines touched while probing, but a hit also touches the line of the value
+struct SplitLayout
+{
+    template <typename K, typename V>
+    using Slots = flat_map::SplitSlots<K, V>;
+};
+
+/// Open addressing hashmap in the spirit of absl::flat_hash_map (SwissTable).
+///
+/// Each slot has a control byte holding 7 bits of the hash of its key (see
+/// flat_map_group.hpp). The table is split in aligned groups of Group::WIDTH
+/// slots: a lookup compares the control bytes of a whole group with a few SIMD
+/// instructions and probes the next groups (triangular sequence) until it finds
+/// one with an empty slot. The erased slots become tombstones unless their group
+/// has an empty slot, and are reused by the insertions.
+///
+/// The table is a power of two of groups, grown when 7/8 of the slots are used.
+/// The interface follows std::unordered_map, the hasher, the equality and the
+/// allocator being the 3rd, 4th and 5th template parameters, then come the
+/// Layout of the slots and the Group used to scan the control bytes. Inserting
+/// or erasing invalidates the iterators.
+template <typename K, typename V,
+          typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>,
+          typename Allocator = std::allocator<std::pair<const K, V>>,
+          typename Layout = InterleavedLayout,
+          typename Group = flat_map::DefaultGroup>
+class FlatMap
+{
+    using Slots = typename Layout::template Slots<K, V>;
+    using Cursor = typename Slots::Cursor;
+    using ctrl_t = flat_map::ctrl_t;
+    static constexpr std::size_t WIDTH = Group::WIDTH;
+    static_assert(Slots::ALIGNMENT <= WIDTH, "the slots are aligned on the group width");
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = typename Slots::value_type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using reference = typename Slots::reference;
+    using const_reference = typename Slots::const_reference;
+    using pointer = typename Slots::pointer;
+    using const_pointer = typename Slots::const_pointer;
+
+    template <bool Const>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename FlatMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, typename FlatMap::const_reference, typename FlatMap::reference>;
+        using pointer = std::conditional_t<Const, typename FlatMap::const_pointer, typename FlatMap::pointer>;
+
+        Iterator() = default;
+
+        /// const_iterator from an iterator
+        template <bool C, typename = std::enable_if_t<Const and not C>>
+        Iterator(const Iterator<C>& other)
+            : m_ctrl(other.m_ctrl)
+            , m_cursor(other.m_cursor)
+        {
+        }
+
+        reference operator*() const { return m_cursor.get(); }
+        pointer operator->() const { return Slots::template arrow<pointer, reference>(**this); }
+
+        Iterator& operator++()
+        {
+            ++m_ctrl;
+            m_cursor.advance(1);
+            skipEmpty();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        template <bool C>
+        bool operator==(const Iterator<C>& other) const { return m_ctrl == other.m_ctrl; }
+        template <bool C>
+        bool operator!=(const Iterator<C>& other) const { return m_ctrl != other.m_ctrl; }
+
+    private:
+        friend class FlatMap;
+        template <bool> friend class Iterator;
+
+        Iterator(const ctrl_t* ctrl, Cursor cursor)
+            : m_ctrl(ctrl)
+            , m_cursor(cursor)
+        {
+        }
+
+        /// Moves to the next full slot or to the sentinel at the end
+        void skipEmpty()
+        {
+            while (*m_ctrl < flat_map::SENTINEL)
+            {
+                const auto shift = Group::unaligned(m_ctrl).countLeadingEmptyOrDeleted();
+                m_ctrl += shift;
+                m_cursor.advance(shift);
+            }
+        }
+
+        const ctrl_t* m_ctrl = nullptr;
+        Cursor m_cursor;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    FlatMap() = default;
+
+    explicit FlatMap(size_type bucketCount,
+                     const Hash& hash = Hash(),
+                     const KeyEqual& equal = KeyEqual(),
+                     const Allocator& allocator = Allocator())
+        : m_hash(hash)
+        , m_equal(equal)
+        , m_allocator(allocator)
+    {
+        reserve(bucketCount);
+    }
+
+    explicit FlatMap(const Allocator& allocator)
+        : m_allocator(allocator)
+    {
+    }
+
+    FlatMap(const FlatMap& other)
+        : m_hash(other.m_hash)
+        , m_equal(other.m_equal)
+        , m_allocator(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.m_allocator))
+    {
+        if (other.m_size == 0)
+        {
+            return;
+        }
+        // built in a temporary which frees the elements already copied if a
+        // copy throws, the constructor of this map not having completed
+        FlatMap copy(0, m_hash, m_equal, m_allocator);
+        copy.allocate(capacityFor(other.m_size));
+        for (size_type i = 0; i < other.m_capacity; ++i)
+        {
+            if (flat_map::isFull(other.m_ctrl[i]))
+            {
+                const auto from = other.cursorAt(i);
+                const auto hash = copy.hashOf(from.key());
+                const auto index = copy.freeSlot(hash);
+                Slots::construct(copy.cursorAt(index), from.key(), from.value());
+                copy.claimSlot(index, hash);
+            }
+        }
+        // allocated with a copy of m_allocator
+        steal(copy);
+    }
+
+    FlatMap(FlatMap&& other) noexcept
+        : m_hash(std::move(other.m_hash))
+        , m_equal(std::move(other.m_equal))
+        , m_allocator(std::move(other.m_allocator))
+    {
+        steal(other);
+    }
+
+    FlatMap& operator=(const FlatMap& other)
+    {
+        if (this != &other)
+        {
+            FlatMap copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    FlatMap& operator=(FlatMap&& other) noexcept
+    {
+        if (this != &other)
+        {
+            destroyAll();
+            deallocate();
+            m_hash = std::move(other.m_hash);
+            m_equal = std::move(other.m_equal);
+            m_allocator = std::move(other.m_allocator);
+            steal(other);
+        }
+        return *this;
+    }
+
+    ~FlatMap()
+    {
+        destroyAll();
+        deallocate();
+    }
+
+    iterator begin()
+    {
+        if (m_size == 0)
+        {
+            return end();
+        }
+        iterator it(m_ctrl, cursorAt(0));
+        it.skipEmpty();
+        return it;
+    }
+
+    const_iterator begin() const { return const_cast<FlatMap*>(this)->begin(); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(m_ctrl + m_capacity, Cursor()); }
+    const_iterator end() const { return const_iterator(m_ctrl + m_capacity, Cursor()); }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const { return m_size == 0; }
+    size_type size() const { return m_size; }
+    size_type capacity() const { return m_capacity; }
+    size_type bucket_count() const { return m_capacity; }
+    float load_factor() const { return m_capacity == 0 ? 0.0f : static_cast<float>(m_size) / m_capacity; }
+    float max_load_factor() const { return 7.0f / 8.0f; }
+    /// Insertions in an empty slot left before the table rehashes: it grows, or
+    /// drops its tombstones at the same capacity when they are what filled it
+    size_type growthLeft() const { return m_growthLeft; }
+    hasher hash_function() const { return m_hash; }
+    key_equal key_eq() const { return m_equal; }
+    allocator_type get_allocator() const { return m_allocator; }
+
+    iterator find(const K& key)
+    {
+        const auto index = findIndex(key, hashOf(key));
+        return index == m_capacity ? end() : iteratorAt(index);
+    }
+
+    const_iterator find(const K& key) const
+    {
+        return const_cast<FlatMap*>(this)->find(key);
+    }
+
+    size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+    bool contains(const K& key) const { return findIndex(key, hashOf(key)) != m_capacity; }
+
+    /// Heterogeneous lookups, when the hasher and the equality are transparent
+    template <typename Key, typename H = Hash, typename E = KeyEqual,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
+    iterator find(const Key& key)
+    {
+        const auto index = findIndex(key, hashOf(key));
+        return index == m_capacity ? end() : iteratorAt(index);
+    }
+
+    template <typename Key, typename H = Hash, typename E = KeyEqual,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
+    const_iterator find(const Key& key) const
+    {
+        return const_cast<FlatMap*>(this)->find(key);
+    }
+
+    template <typename Key, typename H = Hash, typename E = KeyEqual,
+              typename = typename H::is_transparent, typename = typename E::is_transparent>
+    bool contains(const Key& key) const
+    {
+        return findIndex(key, hashOf(key)) != m_capacity;
+    }
+
+    V& at(const K& key)
+    {
+        const auto index = findIndex(key, hashOf(key));
+        if (index == m_capacity)
+        {
+            throw std::out_of_range("yoshi::FlatMap::at: key not found");
+        }
+        return cursorAt(index).value();
+    }
+
+    const V& at(const K& key) const { return const_cast<FlatMap*>(this)->at(key); }
+
+    V& operator[](const K& key) { return cursorAt(tryEmplace(key).first).value(); }
+    V& operator[](K&& key) { return cursorAt(tryEmplace(std::move(key)).first).value(); }
+
+    /// Prefetches the first group of the probing sequence of `key` and its slots
+    void prefetch(const K& key) const
+    {
+        const auto offset = (h1(hashOf(key)) & m_groupMask) * WIDTH;
+        __builtin_prefetch(m_ctrl + offset);
+        if (m_capacity != 0)
+        {
+            __builtin_prefetch(&cursorAt(offset).key());
+        }
+    }
+
+    std::pair<iterator, bool> insert(const value_type& value)
+    {
+        return result(tryEmplace(value.first, value.second));
+    }
+
+    std::pair<iterator, bool> insert(value_type&& value)
+    {
+        return result(tryEmplace(value.first, std::move(value.second)));
+    }
+
+    template <typename P, typename = std::enable_if_t<std::is_constructible<value_type, P&&>::value>>
+    std::pair<iterator, bool> insert(P&& value)
+    {
+        return emplace(std::forward<P>(value));
+    }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            emplace(*first);
+        }
+    }
+
+    void insert(std::initializer_list<value_type> values) { insert(values.begin(), values.end()); }
+
+    template <typename... Args>
+    std::pair<iterator, bool> emplace(Args&&... args)
+    {
+        // the key is needed before choosing the slot
+        std::pair<K, V> value(std::forward<Args>(args)...);
+        return result(tryEmplace(std::move(value.first), std::move(value.second)));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+    {
+        return result(tryEmplace(key, std::forward<Args>(args)...));
+    }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(K&& key, Args&&... args)
+    {
+        return result(tryEmplace(std::move(key), std::forward<Args>(args)...));
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value)
+    {
+        auto r = tryEmplace(key, std::forward<M>(value));
+        if (not r.second)
+        {
+            cursorAt(r.first).value() = std::forward<M>(value);
+        }
+        return result(r);
+    }
+
+    size_type erase(const K& key)
+    {
+        const auto index = findIndex(key, hashOf(key));
+        if (index == m_capacity)
+        {
+            return 0;
+        }
+        eraseAt(index);
+        return 1;
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        const auto index = static_cast<size_type>(pos.m_ctrl - m_ctrl);
+        eraseAt(index);
+        iterator next(m_ctrl + index, cursorAt(index));
+        next.skipEmpty();
+        return next;
+    }
+
+    iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+    void clear()
+    {
+        if (m_capacity == 0)
+        {
+            return;
+        }
+        destroyAll();
+        std::memset(m_ctrl, flat_map::EMPTY, m_capacity);
+        m_size = 0;
+        m_growthLeft = growth(m_capacity);
+    }
+
+    /// Makes room for `count` elements without growing
+    void reserve(size_type count)
+    {
+        if (count > m_size + m_growthLeft)
+        {
+            resize(capacityFor(count));
+        }
+    }
+
+    /// Resizes the table to the smallest capacity holding max(count, size())
+    /// elements, which also drops the tombstones: rehash(0) shrinks to fit
+    void rehash(size_type count)
+    {
+        count = count > m_size ? count : m_size;
+        if (count == 0)
+        {
+            deallocate();
+            m_ctrl = flat_map::emptyGroup<WIDTH>();
+            m_slots = nullptr;
+            m_capacity = 0;
+            m_groupMask = 0;
+            m_growthLeft = 0;
+            return;
+        }
+        resize(capacityFor(count));
+    }
+
+    void swap(FlatMap& other) noexcept
+    {
+        using std::swap;
+        swap(m_hash, other.m_hash);
+        swap(m_equal, other.m_equal);
+        swap(m_allocator, other.m_allocator);
+        swap(m_ctrl, other.m_ctrl);
+        swap(m_slots, other.m_slots);
+        swap(m_size, other.m_size);
+        swap(m_capacity, other.m_capacity);
+        swap(m_groupMask, other.m_groupMask);
+        swap(m_growthLeft, other.m_growthLeft);
+    }
+
+private:
+    struct alignas(WIDTH) Chunk
+    {
+        unsigned char bytes[WIDTH];
+    };
+    using ChunkAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Chunk>;
+
+    /// Group of the probing sequence and its 7 bits tag in the control bytes
+    static std::uint64_t h1(std::uint64_t hash) { return hash >> 7; }
+    static ctrl_t h2(std::uint64_t hash) { return static_cast<ctrl_t>(hash & 0x7F); }
+
+    static size_type growth(size_type capacity) { return capacity - capacity / 8; }
+
+    static size_type capacityFor(size_type count)
+    {
+        size_type capacity = WIDTH;
+        while (growth(capacity) < count)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    /// Control bytes then the slots, in chunks aligned on the group width
+    static size_type chunks(size_type capacity)
+    {
+        return (capacity + WIDTH + Slots::bytes(capacity) + WIDTH - 1) / WIDTH;
+    }
+
+    template <typename Key>
+    std::uint64_t hashOf(const Key& key) const { return flat_map::mix(m_hash(key)); }
+
+    Cursor cursorAt(size_type index) const { return Slots::at(m_slots, m_capacity, index); }
+    iterator iteratorAt(size_type index) { return iterator(m_ctrl + index, cursorAt(index)); }
+
+    std::pair<iterator, bool> result(std::pair<size_type, bool> r)
+    {
+        return {iteratorAt(r.first), r.second};
+    }
+
+    /// Returns the index of `key`, or m_capacity if it is not in the table
+    template <typename Key>
+    size_type findIndex(const Key& key, std::uint64_t hash) const
+    {
+        const auto tag = h2(hash);
+        size_type group = h1(hash) & m_groupMask;
+        for (size_type step = 1;; ++step)
+        {
+            const auto offset = group * WIDTH;
+            const Group g(m_ctrl + offset);
+            for (auto i : g.match(tag))
+            {
+                if (m_equal(cursorAt(offset + i).key(), key))
+                {
+                    return offset + i;
+                }
+            }
+            if (g.matchEmpty())
+            {
+                return m_capacity;
+            }
+            group = (group + step) & m_groupMask;
+        }
+    }
+
+    /// Returns the first empty or deleted slot of the probing sequence
+    size_type findFirstNonFull(std::uint64_t hash) const
+    {
+        size_type group = h1(hash) & m_groupMask;
+        for (size_type step = 1;; ++step)
+        {
+            const auto offset = group * WIDTH;
+            if (auto mask = Group(m_ctrl + offset).matchEmptyOrDeleted())
+            {
+                return offset + mask.lowest();
+            }
+            group = (group + step) & m_groupMask;
+        }
+    }
+
+    /// Returns the index of the slot of a new element, growing the table if
+    /// needed. The slot is only taken by claimSlot, once the element is built.
+    size_type freeSlot(std::uint64_t hash)
+    {
+        auto index = findFirstNonFull(hash);
+        if (m_growthLeft == 0 and m_ctrl[index] != flat_map::DELETED)
+        {
+            // full of tombstones: rehash at the same capacity, else grow
+            const bool tombstones = m_size * 32 <= m_capacity * 25;
+            resize(m_capacity != 0 and tombstones ? m_capacity : capacityFor(m_size + 1));
+            index = findFirstNonFull(hash);
+        }
+        return index;
+    }
+
+    /// Marks the slot given by freeSlot as full
+    void claimSlot(size_type index, std::uint64_t hash)
+    {
+        m_growthLeft -= (m_ctrl[index] == flat_map::EMPTY);
+        m_ctrl[index] = h2(hash);
+        ++m_size;
+    }
+
+    /// Returns the index of `key` and if it got inserted
+    template <typename Key, typename... Args>
+    std::pair<size_type, bool> tryEmplace(Key&& key, Args&&... args)
+    {
+        const auto hash = hashOf(key);
+        auto index = findIndex(key, hash);
+        if (index != m_capacity)
+        {
+            return {index, false};
+        }
+        // the slot keeps its empty or deleted state if the element throws
+        index = freeSlot(hash);
+        Slots::construct(cursorAt(index), std::forward<Key>(key), std::forward<Args>(args)...);
+        claimSlot(index, hash);
+        return {index, true};
+    }
+
+    void eraseAt(size_type index)
+    {
+        Slots::destroy(cursorAt(index));
+        eraseCtrl(index);
+    }
+
+    /// A slot can go back to empty if its group has an empty slot: no lookup
+    /// went past this group looking for a key
+    void eraseCtrl(size_type index)
+    {
+        --m_size;
+        if (Group(m_ctrl + (index & ~(WIDTH - 1))).matchEmpty())
+        {
+            m_ctrl[index] = flat_map::EMPTY;
+            ++m_growthLeft;
+        }
+        else
+        {
+            m_ctrl[index] = flat_map::DELETED;
+        }
+    }
+
+    void destroyAll()
+    {
+        if (Slots::TRIVIALLY_DESTRUCTIBLE or m_size == 0)
+        {
+            return;
+        }
+        for (size_type i = 0; i < m_capacity; ++i)
+        {
+            if (flat_map::isFull(m_ctrl[i]))
+            {
+                Slots::destroy(cursorAt(i));
+            }
+        }
+    }
+
+    /// Allocates an empty table of `capacity` slots, m_size being kept
+    void allocate(size_type capacity)
+    {
+        ChunkAllocator allocator(m_allocator);
+        auto* p = std::allocator_traits<ChunkAllocator>::allocate(allocator, chunks(capacity));
+        m_ctrl = reinterpret_cast<ctrl_t*>(p);
+        m_slots = reinterpret_cast<char*>(p) + capacity + WIDTH;
+        std::memset(m_ctrl, flat_map::EMPTY, capacity);
+        std::memset(m_ctrl + capacity, flat_map::SENTINEL, WIDTH);
+        m_capacity = capacity;
+        m_groupMask = capacity / WIDTH - 1;
+        m_growthLeft = growth(capacity) - m_size;
+    }
+
+    void deallocate()
+    {
+        if (m_capacity == 0)
+        {
+            return;
+        }
+        ChunkAllocator allocator(m_allocator);
+        std::allocator_traits<ChunkAllocator>::deallocate(
+            allocator, reinterpret_cast<Chunk*>(m_ctrl), chunks(m_capacity));
+    }
+
+    /// Moves all the elements to a new table of `capacity` slots
+    void resize(size_type capacity)
+    {
+        auto* oldCtrl = m_ctrl;
+        auto* oldSlots = m_slots;
+        const auto oldCapacity = m_capacity;
+        allocate(capacity);
+        for (size_type i = 0; i < oldCapacity; ++i)
+        {
+            if (flat_map::isFull(oldCtrl[i]))
+            {
+                const auto from = Slots::at(oldSlots, oldCapacity, i);
+                const auto hash = hashOf(from.key());
+                const auto index = findFirstNonFull(hash);
+                m_ctrl[index] = h2(hash);
+                Slots::transfer(cursorAt(index), from);
+            }
+        }
+        if (oldCapacity != 0)
+        {
+            ChunkAllocator allocator(m_allocator);
+            std::allocator_traits<ChunkAllocator>::deallocate(
+                allocator, reinterpret_cast<Chunk*>(oldCtrl), chunks(oldCapacity));
+        }
+    }
+
+    /// Takes the table of `other`, leaving it empty
+    void steal(FlatMap& other)
+    {
+        m_ctrl = other.m_ctrl;
+        m_slots = other.m_slots;
+        m_size = other.m_size;
+        m_capacity = other.m_capacity;
+        m_groupMask = other.m_groupMask;
+        m_growthLeft = other.m_growthLeft;
+        other.m_ctrl = flat_map::emptyGroup<WIDTH>();
+        other.m_slots = nullptr;
+        other.m_size = 0;
+        other.m_capacity = 0;
+        other.m_groupMask = 0;
+        other.m_growthLeft = 0;
+    }
+
+    Hash m_hash;
+    KeyEqual m_equal;
+    Allocator m_allocator;
+    ctrl_t* m_ctrl = flat_map::emptyGroup<WIDTH>();
+    void* m_slots = nullptr;
+    size_type m_size = 0;
+    size_type m_capacity = 0;
+    /// Number of groups - 1
+    size_type m_groupMask = 0;
+    /// Number of empty slots which can be filled before growing
+    size_type m_growthLeft = 0;
+};
+
+}
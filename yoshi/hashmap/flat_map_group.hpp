@@ -0,0 +1,224 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+/// Control bytes of yoshi::FlatMap and the groups scanning them.
+///
+/// Each slot of the table has a control byte: the 7 low bits of the hash of its
+/// key when it is full, else one of the negative values below. The lookups
+/// compare a whole group of control bytes at once and only look at the keys of
+/// the slots whose byte matches.
+namespace yoshi {
+namespace flat_map {
+
+using ctrl_t = std::int8_t;
+
+constexpr ctrl_t EMPTY = -128;
+constexpr ctrl_t DELETED = -2;
+/// Marks the end of the table for the iterators
+constexpr ctrl_t SENTINEL = -1;
+
+inline bool isFull(ctrl_t c) { return c >= 0; }
+
+/// Set of the positions matching in a group, iterated from the lowest one.
+/// Each position takes 2^Shift bits.
+template <typename T, int Shift>
+class BitMask
+{
+public:
+    explicit BitMask(T mask)
+        : m_mask(mask)
+    {
+    }
+
+    explicit operator bool() const { return m_mask != 0; }
+
+    /// Returns the lowest position
+    std::uint32_t lowest() const
+    {
+        return static_cast<std::uint32_t>(__builtin_ctzll(m_mask)) >> Shift;
+    }
+
+    BitMask& operator++()
+    {
+        m_mask &= m_mask - 1;
+        return *this;
+    }
+
+    // iteration over the positions: for (auto i : mask)
+    BitMask begin() const { return *this; }
+    BitMask end() const { return BitMask(0); }
+    std::uint32_t operator*() const { return lowest(); }
+    bool operator!=(const BitMask& other) const { return m_mask != other.m_mask; }
+
+private:
+    T m_mask;
+};
+
+#if defined(__SSE2__)
+/// 16 control bytes scanned with SSE2: compare then movemask
+struct GroupSse2
+{
+    static constexpr std::size_t WIDTH = 16;
+    using Mask = BitMask<std::uint32_t, 0>;
+
+    /// Loads the group at `ctrl`, which must be aligned on WIDTH
+    explicit GroupSse2(const ctrl_t* ctrl)
+        : m_ctrl(_mm_load_si128(reinterpret_cast<const __m128i*>(ctrl)))
+    {
+    }
+
+    /// Loads the group at `ctrl` without alignment requirement
+    static GroupSse2 unaligned(const ctrl_t* ctrl)
+    {
+        return GroupSse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)));
+    }
+
+    Mask match(ctrl_t h2) const
+    {
+        return Mask(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl)));
+    }
+
+    Mask matchEmpty() const
+    {
+        return Mask(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(EMPTY), m_ctrl)));
+    }
+
+    Mask matchEmptyOrDeleted() const
+    {
+        return Mask(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(SENTINEL), m_ctrl)));
+    }
+
+    /// Number of empty or deleted slots before the first full one (or the sentinel)
+    std::uint32_t countLeadingEmptyOrDeleted() const
+    {
+        // the extra bit stops the count at the end of the group
+        const auto full = _mm_movemask_epi8(_mm_cmpgt_epi8(m_ctrl, _mm_set1_epi8(DELETED)));
+        return __builtin_ctz(full | (1u << WIDTH));
+    }
+
+private:
+    explicit GroupSse2(__m128i ctrl)
+        : m_ctrl(ctrl)
+    {
+    }
+
+    __m128i m_ctrl;
+};
+#endif
+
+#if defined(__AVX2__)
+/// 32 control bytes, two SSE groups, scanned at once with AVX2
+struct GroupAvx2
+{
+    static constexpr std::size_t WIDTH = 32;
+    using Mask = BitMask<std::uint32_t, 0>;
+
+    explicit GroupAvx2(const ctrl_t* ctrl)
+        : m_ctrl(_mm256_load_si256(reinterpret_cast<const __m256i*>(ctrl)))
+    {
+    }
+
+    static GroupAvx2 unaligned(const ctrl_t* ctrl)
+    {
+        return GroupAvx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ctrl)));
+    }
+
+    Mask match(ctrl_t h2) const
+    {
+        return movemask(_mm256_cmpeq_epi8(_mm256_set1_epi8(h2), m_ctrl));
+    }
+
+    Mask matchEmpty() const
+    {
+        return movemask(_mm256_cmpeq_epi8(_mm256_set1_epi8(EMPTY), m_ctrl));
+    }
+
+    Mask matchEmptyOrDeleted() const
+    {
+        return movemask(_mm256_cmpgt_epi8(_mm256_set1_epi8(SENTINEL), m_ctrl));
+    }
+
+    std::uint32_t countLeadingEmptyOrDeleted() const
+    {
+        const auto full = static_cast<std::uint32_t>(
+            _mm256_movemask_epi8(_mm256_cmpgt_epi8(m_ctrl, _mm256_set1_epi8(DELETED))));
+        return __builtin_ctzll(full | (1ULL << WIDTH));
+    }
+
+private:
+    explicit GroupAvx2(__m256i ctrl)
+        : m_ctrl(ctrl)
+    {
+    }
+
+    static Mask movemask(__m256i v)
+    {
+        return Mask(static_cast<std::uint32_t>(_mm256_movemask_epi8(v)));
+    }
+
+    __m256i m_ctrl;
+};
+#endif
+
+/// 8 control bytes scanned with 64 bits arithmetic, for the targets without SSE2
+struct GroupPortable
+{
+    static constexpr std::size_t WIDTH = 8;
+    using Mask = BitMask<std::uint64_t, 3>;
+
+    explicit GroupPortable(const ctrl_t* ctrl)
+    {
+        std::memcpy(&m_ctrl, ctrl, sizeof(m_ctrl));
+    }
+
+    static GroupPortable unaligned(const ctrl_t* ctrl) { return GroupPortable(ctrl); }
+
+    Mask match(ctrl_t h2) const
+    {
+        // the bytes equal to h2 become 0, then the usual "has zero byte" trick
+        const std::uint64_t x = m_ctrl ^ (LSBS * static_cast<std::uint8_t>(h2));
+        return Mask((x - LSBS) & ~x & MSBS);
+    }
+
+    Mask matchEmpty() const
+    {
+        // only EMPTY has its high bit set and its bit 1 cleared
+        return Mask(m_ctrl & ~(m_ctrl << 6) & MSBS);
+    }
+
+    Mask matchEmptyOrDeleted() const
+    {
+        // EMPTY and DELETED have the high bit set and the bit 0 cleared
+        return Mask(m_ctrl & ~(m_ctrl << 7) & MSBS);
+    }
+
+    std::uint32_t countLeadingEmptyOrDeleted() const
+    {
+        const std::uint64_t full = ~(m_ctrl & ~(m_ctrl << 7)) & MSBS;
+        return full == 0 ? WIDTH : __builtin_ctzll(full) >> 3;
+    }
+
+private:
+    static constexpr std::uint64_t LSBS = 0x0101010101010101ULL;
+    static constexpr std::uint64_t MSBS = 0x8080808080808080ULL;
+
+    std::uint64_t m_ctrl;
+};
+
+#if defined(__SSE2__)
+using DefaultGroup = GroupSse2;
+#else
+using DefaultGroup = GroupPortable;
+#endif
+
+}
+}
@@ -0,0 +1,144 @@
+#include "flat_map.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+/// Value counting its instances, whose copies throw once `s_copies` reaches 0
+struct Throwing
+{
+    static inline std::int64_t s_live = 0;
+    static inline std::int64_t s_copies = -1;
+
+    Throwing() { ++s_live; }
+    Throwing(const Throwing&)
+    {
+        if (s_copies == 0)
+        {
+            throw std::runtime_error("copy");
+        }
+        --s_copies;
+        ++s_live;
+    }
+    ~Throwing() { --s_live; }
+};
+
+using Map = yoshi::FlatMap<std::int64_t, Throwing>;
+
+/// Tries to insert `key` with a throwing copy, returns false if it did not throw
+bool insertThrowing(Map& map, std::int64_t key)
+{
+    const Throwing value;
+    Throwing::s_copies = 0;
+    try
+    {
+        map.try_emplace(key, value);
+    }
+    catch (const std::runtime_error&)
+    {
+        Throwing::s_copies = -1;
+        return true;
+    }
+    Throwing::s_copies = -1;
+    return false;
+}
+
+/// Checks that throwing inserts of the keys [first, last) by `step` leave the
+/// map, whose keys are in [0, first), as it was
+int checkUnchanged(Map& map, std::int64_t first, std::int64_t last, std::int64_t step)
+{
+    const auto size = map.size();
+    const auto growthLeft = map.growthLeft();
+    for (std::int64_t key = first; key < last; key += step)
+    {
+        if (not insertThrowing(map, key))
+        {
+            std::cerr << "excepted the insert of " << key << " to throw\n";
+            return 1;
+        }
+        if (map.size() != size or map.growthLeft() != growthLeft or map.contains(key))
+        {
+            std::cerr << "excepted the map to be unchanged by the throwing insert of " << key
+                      << ", got " << map.size() << " elements and " << map.growthLeft()
+                      << " growth left instead of " << size << " and " << growthLeft << "\n";
+            return 1;
+        }
+    }
+    std::size_t found = 0;
+    for (std::int64_t key = 0; key < first; ++key)
+    {
+        found += map.contains(key);
+    }
+    if (found != size)
+    {
+        std::cerr << "excepted to find " << size << " elements, got " << found << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+/// Checks that a throwing insert leaves the map as it was, for the new elements
+/// going in an empty slot and the ones going in a deleted slot
+int checkInsert()
+{
+    // filled up to its growth, many groups have a single empty slot
+    Map map(1000);
+    std::int64_t count = 0;
+    while (map.growthLeft() > 1)
+    {
+        map.try_emplace(count++);
+    }
+    if (checkUnchanged(map, count, 2 * count, 1) != 0)
+    {
+        return 1;
+    }
+    // tombstones in the full groups
+    for (std::int64_t key = 0; key < count; key += 3)
+    {
+        map.erase(key);
+    }
+    return checkUnchanged(map, count, 2 * count, 1);
+}
+
+/// Checks that a copy throwing in the middle frees the elements already copied
+int checkCopy()
+{
+    Map map;
+    for (std::int64_t key = 0; key < 1000; ++key)
+    {
+        map.try_emplace(key);
+    }
+    const auto live = Throwing::s_live;
+    Throwing::s_copies = 500;
+    try
+    {
+        Map copy(map);
+        std::cerr << "excepted the copy to throw\n";
+        return 1;
+    }
+    catch (const std::runtime_error&)
+    {
+    }
+    Throwing::s_copies = -1;
+    if (Throwing::s_live != live)
+    {
+        std::cerr << "excepted " << live << " values after the throwing copy, got " << Throwing::s_live << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+}
+
+/// Checks the flat map is left unchanged when the copy of an element throws
+int main()
+{
+    if (checkInsert() != 0 or checkCopy() != 0)
+    {
+        return 1;
+    }
+    std::cout << "flat map unchanged by the throwing copies\n";
+    return 0;
+}
@@ -3,3 +3,4 @@
 #include "folly/container/F14Map.h"
 
 DECLARE_ALL_TESTS(folly::F14FastMap)
+DECLARE_ALLOCATOR_TESTS(folly_f14_fast_map, folly::F14FastMap)
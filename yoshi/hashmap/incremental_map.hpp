@@ -0,0 +1,363 @@
+#pragma once
+
+#include "flat_map.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace yoshi {
+
+/// Hashmap growing without moving all its elements at once, to compare with the
+/// growth stall of the other hashmaps.
+///
+/// Made of two yoshi::FlatMap: when the current table is full, a table twice as
+/// large replaces it and the previous one is drained STEP elements at a time by
+/// the next insertions and erasures, like the incremental rehash of redis. A
+/// table full of tombstones is replaced the same way by a table of the same
+/// capacity, instead of being rehashed at once. During
+/// the migration the lookups search both tables and both are allocated, as during
+/// the growth of the other hashmaps but for longer. reserve(), rehash() and the
+/// copies finish the migration. Inserting or erasing invalidates the iterators.
+template <typename K, typename V,
+          typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>,
+          typename Allocator = std::allocator<std::pair<const K, V>>>
+class IncrementalMap
+{
+    using Table = FlatMap<K, V, Hash, KeyEqual, Allocator>;
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = typename Table::value_type;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using allocator_type = Allocator;
+    using reference = typename Table::reference;
+    using const_reference = typename Table::const_reference;
+    using pointer = typename Table::pointer;
+    using const_pointer = typename Table::const_pointer;
+
+    /// Elements moved to the current table by each insertion or erasure
+    static constexpr size_type STEP = 8;
+
+    /// Iterates over the current table then over the previous one
+    template <bool Const>
+    class Iterator
+    {
+        using Map = std::conditional_t<Const, const IncrementalMap, IncrementalMap>;
+        using Inner = std::conditional_t<Const, typename Table::const_iterator, typename Table::iterator>;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename IncrementalMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = typename std::iterator_traits<Inner>::reference;
+        using pointer = typename std::iterator_traits<Inner>::pointer;
+
+        Iterator() = default;
+
+        /// const_iterator from an iterator
+        template <bool C, typename = std::enable_if_t<Const and not C>>
+        Iterator(const Iterator<C>& other)
+            : m_map(other.m_map)
+            , m_it(other.m_it)
+            , m_current(other.m_current)
+        {
+        }
+
+        reference operator*() const { return *m_it; }
+        pointer operator->() const { return m_it.operator->(); }
+
+        Iterator& operator++()
+        {
+            ++m_it;
+            nextTable();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        template <bool C>
+        bool operator==(const Iterator<C>& other) const { return m_it == other.m_it; }
+        template <bool C>
+        bool operator!=(const Iterator<C>& other) const { return m_it != other.m_it; }
+
+    private:
+        friend class IncrementalMap;
+        template <bool> friend class Iterator;
+
+        Iterator(Map* map, Inner it, bool current)
+            : m_map(map)
+            , m_it(it)
+            , m_current(current)
+        {
+            nextTable();
+        }
+
+        /// Goes on with the previous table at the end of the current one
+        void nextTable()
+        {
+            if (m_current and m_it == m_map->m_table.end() and m_map->migrating())
+            {
+                m_it = m_map->m_old.begin();
+                m_current = false;
+            }
+        }
+
+        Map* m_map = nullptr;
+        Inner m_it;
+        bool m_current = true;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    IncrementalMap() = default;
+
+    explicit IncrementalMap(const Allocator& allocator)
+        : m_table(allocator)
+        , m_old(allocator)
+    {
+    }
+
+    IncrementalMap(const IncrementalMap& other)
+        : m_table(other.m_table)
+        , m_old(other.m_old)
+        , m_cursor(m_old.begin())
+    {
+        finish();
+    }
+
+    IncrementalMap(IncrementalMap&& other) = default;
+
+    IncrementalMap& operator=(const IncrementalMap& other)
+    {
+        if (this != &other)
+        {
+            IncrementalMap copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    IncrementalMap& operator=(IncrementalMap&& other) = default;
+
+    iterator begin() { return iterator(this, m_table.begin(), true); }
+    const_iterator begin() const { return const_iterator(this, m_table.begin(), true); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return migrating() ? iterator(this, m_old.end(), false) : iterator(this, m_table.end(), true); }
+    const_iterator end() const
+    {
+        return migrating() ? const_iterator(this, m_old.end(), false) : const_iterator(this, m_table.end(), true);
+    }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const { return size() == 0; }
+    size_type size() const { return m_table.size() + m_old.size(); }
+    /// Capacity of the current table
+    size_type capacity() const { return m_table.capacity(); }
+    size_type bucket_count() const { return m_table.capacity(); }
+    bool migrating() const { return not m_old.empty(); }
+    hasher hash_function() const { return m_table.hash_function(); }
+    key_equal key_eq() const { return m_table.key_eq(); }
+    allocator_type get_allocator() const { return m_table.get_allocator(); }
+
+    iterator find(const K& key)
+    {
+        auto it = m_table.find(key);
+        if (it != m_table.end())
+        {
+            return iterator(this, it, true);
+        }
+        if (migrating())
+        {
+            auto old = m_old.find(key);
+            if (old != m_old.end())
+            {
+                return iterator(this, old, false);
+            }
+        }
+        return end();
+    }
+
+    const_iterator find(const K& key) const
+    {
+        auto it = const_cast<IncrementalMap*>(this)->find(key);
+        return const_iterator(it);
+    }
+
+    bool contains(const K& key) const
+    {
+        return m_table.contains(key) or (migrating() and m_old.contains(key));
+    }
+
+    size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+    void prefetch(const K& key) const { m_table.prefetch(key); }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value) { return try_emplace(value.first, std::move(value.second)); }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+    {
+        growIfFull();
+        migrate();
+        if (migrating())
+        {
+            auto old = m_old.find(key);
+            if (old != m_old.end())
+            {
+                return {iterator(this, old, false), false};
+            }
+        }
+        auto r = m_table.try_emplace(key, std::forward<Args>(args)...);
+        return {iterator(this, r.first, true), r.second};
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value)
+    {
+        auto r = try_emplace(key, std::forward<M>(value));
+        if (not r.second)
+        {
+            r.first->second = std::forward<M>(value);
+        }
+        return r;
+    }
+
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+    size_type erase(const K& key)
+    {
+        migrate();
+        if (m_table.erase(key) != 0)
+        {
+            return 1;
+        }
+        if (migrating())
+        {
+            auto old = m_old.find(key);
+            if (old != m_old.end())
+            {
+                eraseOld(old);
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    void clear()
+    {
+        m_table.clear();
+        m_old.clear();
+        m_old.rehash(0);
+        m_cursor = {};
+    }
+
+    void reserve(size_type count)
+    {
+        finish();
+        m_table.reserve(count);
+    }
+
+    void rehash(size_type count)
+    {
+        finish();
+        m_table.rehash(count);
+    }
+
+    void swap(IncrementalMap& other) noexcept
+    {
+        using std::swap;
+        m_table.swap(other.m_table);
+        m_old.swap(other.m_old);
+        swap(m_cursor, other.m_cursor);
+    }
+
+private:
+    /// Starts the migration to a new table when the current one would rehash by
+    /// itself on the next insertion in an empty slot: full of elements, the new
+    /// table is twice as large, full of tombstones (insertions and erasures) it
+    /// has the same capacity, the migration dropping the tombstones
+    void growIfFull()
+    {
+        const auto capacity = m_table.capacity();
+        if (migrating() or capacity == 0 or m_table.growthLeft() > 0)
+        {
+            return;
+        }
+        // the previous table is empty and released
+        m_old.swap(m_table);
+        const auto size = m_old.size();
+        // same threshold as the rehash of FlatMap
+        const bool tombstones = size * 32 <= capacity * 25;
+        // and room for the insertions of the migration (see migrate)
+        m_table.reserve(std::max(tombstones ? capacity - capacity / 8 : 2 * size, size + size / STEP + 1));
+        if (m_old.empty())
+        {
+            m_old.rehash(0);
+            return;
+        }
+        m_cursor = m_old.begin();
+    }
+
+    /// Moves up to STEP elements of the previous table to the current one. The
+    /// current table holds at most 1 + 1 / STEP times the size of the previous
+    /// one when it is drained, so it never grows during the migration.
+    void migrate()
+    {
+        for (size_type i = 0; i < STEP and migrating(); ++i)
+        {
+            m_table.try_emplace(m_cursor->first, std::move(m_cursor->second));
+            eraseOld(m_cursor);
+        }
+    }
+
+    void finish()
+    {
+        while (migrating())
+        {
+            migrate();
+        }
+    }
+
+    /// Erases from the previous table, keeping the cursor of the migration on
+    /// the next element to move: the elements before it are already moved
+    void eraseOld(typename Table::iterator it)
+    {
+        if (it == m_cursor)
+        {
+            m_cursor = m_old.erase(it);
+        }
+        else
+        {
+            m_old.erase(it);
+        }
+        if (m_old.empty())
+        {
+            m_old.rehash(0);
+            m_cursor = {};
+        }
+    }
+
+    Table m_table;
+    /// Previous table being drained, empty and not allocated out of the migrations
+    Table m_old;
+    typename Table::iterator m_cursor;
+};
+
+}
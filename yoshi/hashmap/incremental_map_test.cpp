@@ -0,0 +1,67 @@
+#include "incremental_map.hpp"
+
+#include <cstdint>
+#include <iostream>
+
+namespace {
+
+/// Fills `map` up to a migration and returns the number of keys inserted, or
+/// 0 if no migration started
+std::int64_t fillUntilMigrating(yoshi::IncrementalMap<std::int64_t, std::int64_t>& map)
+{
+    for (std::int64_t key = 0; key < 100000; ++key)
+    {
+        map.insert({key, key});
+        if (map.migrating())
+        {
+            return key + 1;
+        }
+    }
+    return 0;
+}
+
+}
+
+/// Checks that clearing the map during a migration empties both tables, and
+/// that the map can be filled and cleared again after
+int main()
+{
+    yoshi::IncrementalMap<std::int64_t, std::int64_t> map;
+    for (int round = 0; round < 3; ++round)
+    {
+        const auto inserted = fillUntilMigrating(map);
+        if (inserted == 0)
+        {
+            std::cerr << "excepted a migration in round " << round << "\n";
+            return 1;
+        }
+        map.clear();
+        if (map.size() != 0 or map.migrating() or map.find(0) != map.end())
+        {
+            std::cerr << "excepted an empty map after a clear during a migration, got "
+                      << map.size() << " elements\n";
+            return 1;
+        }
+        for (std::int64_t key = 0; key < 2 * inserted; ++key)
+        {
+            map.insert({key, -key});
+        }
+        if (map.size() != static_cast<std::size_t>(2 * inserted))
+        {
+            std::cerr << "excepted " << 2 * inserted << " elements, got " << map.size() << "\n";
+            return 1;
+        }
+        for (std::int64_t key = 0; key < 2 * inserted; ++key)
+        {
+            auto it = map.find(key);
+            if (it == map.end() or it->second != -key)
+            {
+                std::cerr << "excepted to find " << key << " after the clear\n";
+                return 1;
+            }
+        }
+        map.clear();
+    }
+    std::cout << "incremental map cleared during its migrations\n";
+    return 0;
+}
@@ -0,0 +1,580 @@
+#pragma once
+
+#include "flat_map.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace yoshi {
+
+/// Open addressing hashmap stored in a single block of memory without any
+/// pointer, which can be a memory mapped file (in /dev/shm to share it between
+/// processes without a disk).
+///
+/// The block starts with a header giving the capacity, the size and the offsets
+/// of the control bytes and of the slots from its beginning, so it is valid at
+/// any address: a process creates the file with create() and fills it, the
+/// others open() it read only and find in place without copying or rebuilding
+/// it, the pages being loaded by the lookups touching them. The keys and values
+/// must be trivially copyable and the hasher must give the same hashes in all
+/// the processes (no random seed). The file must not be modified while opened.
+///
+/// Linear probing on a power of two of slots, with a control byte per slot
+/// holding 7 bits of the hash, grown when 3/4 of the slots are used or erased.
+/// A default constructed map lives on the heap like the other maps. Inserting
+/// or erasing invalidates the iterators, modifying an opened map throws.
+template <typename K, typename V,
+          typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>>
+class MappedMap
+{
+    static_assert(std::is_trivially_copyable<K>::value and std::is_trivially_copyable<V>::value,
+                  "the elements are stored as raw memory");
+
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using hasher = Hash;
+    using key_equal = KeyEqual;
+    using reference = value_type&;
+    using const_reference = const value_type&;
+    using pointer = value_type*;
+    using const_pointer = const value_type*;
+
+private:
+    /// Beginning of the block, all the positions are offsets from it
+    struct Header
+    {
+        std::uint64_t magic;
+        std::uint32_t version;
+        /// sizes of the types, to reject the files of other types
+        std::uint32_t elementSize;
+        std::uint32_t keySize;
+        std::uint32_t mappedSize;
+        std::uint64_t capacity;
+        std::uint64_t size;
+        std::uint64_t erased;
+        std::uint64_t controlOffset;
+        std::uint64_t slotsOffset;
+        std::uint64_t bytes;
+    };
+
+    /// "yoshimap" in little endian
+    static constexpr std::uint64_t MAGIC = 0x70616d6968736f79;
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::uint8_t EMPTY = 0;
+    static constexpr std::uint8_t ERASED = 1;
+    /// set in the control bytes of the used slots, with 7 bits of the hash
+    static constexpr std::uint8_t FULL = 0x80;
+    static constexpr size_type MIN_CAPACITY = 16;
+    static constexpr size_type ALIGNMENT = 64;
+    static constexpr size_type NONE = ~size_type(0);
+
+public:
+    template <bool Const>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename MappedMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+        Iterator() = default;
+
+        /// const_iterator from an iterator
+        template <bool C, typename = std::enable_if_t<Const and not C>>
+        Iterator(const Iterator<C>& other)
+            : m_control(other.m_control)
+            , m_slots(other.m_slots)
+            , m_index(other.m_index)
+            , m_capacity(other.m_capacity)
+        {
+        }
+
+        reference operator*() const { return m_slots[m_index]; }
+        pointer operator->() const { return &m_slots[m_index]; }
+
+        Iterator& operator++()
+        {
+            ++m_index;
+            skipFree();
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        template <bool C>
+        bool operator==(const Iterator<C>& other) const { return m_index == other.m_index; }
+        template <bool C>
+        bool operator!=(const Iterator<C>& other) const { return m_index != other.m_index; }
+
+    private:
+        friend class MappedMap;
+        template <bool> friend class Iterator;
+
+        Iterator(const std::uint8_t* control, value_type* slots, size_type index, size_type capacity)
+            : m_control(control)
+            , m_slots(slots)
+            , m_index(index)
+            , m_capacity(capacity)
+        {
+            skipFree();
+        }
+
+        void skipFree()
+        {
+            while (m_index < m_capacity and not (m_control[m_index] & FULL))
+            {
+                ++m_index;
+            }
+        }
+
+        const std::uint8_t* m_control = nullptr;
+        value_type* m_slots = nullptr;
+        size_type m_index = 0;
+        size_type m_capacity = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    MappedMap() = default;
+
+    /// Copies the elements on the heap, the copy can be modified
+    MappedMap(const MappedMap& other)
+        : m_hash(other.m_hash)
+        , m_equal(other.m_equal)
+    {
+        if (other.m_base != nullptr)
+        {
+            m_base = allocateHeap(other.header().bytes);
+            std::memcpy(m_base, other.m_base, other.header().bytes);
+        }
+    }
+
+    MappedMap(MappedMap&& other) noexcept
+    {
+        swap(other);
+    }
+
+    MappedMap& operator=(MappedMap other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~MappedMap()
+    {
+        release();
+    }
+
+    /// Creates the file `path` (truncated if it exists) holding an empty map
+    /// with room for `count` elements, mapped read write. Its elements are
+    /// written in the file, which grows with the map.
+    static MappedMap create(const std::string& path, size_type count = 0)
+    {
+        MappedMap map;
+        map.m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (map.m_fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "excepted a writable file " + path);
+        }
+        map.resizeFile(bytesFor(capacityFor(count)));
+        map.initialize(capacityFor(count));
+        return map;
+    }
+
+    /// Maps the map written in the file `path` read only, loading all its pages
+    /// up front with `populate` instead of on the first lookups touching them.
+    /// Throws if the file is not a map of these key and value types.
+    static MappedMap open(const std::string& path, bool populate = false)
+    {
+        MappedMap map;
+        map.m_fd = ::open(path.c_str(), O_RDONLY);
+        struct stat status;
+        if (map.m_fd < 0 or ::fstat(map.m_fd, &status) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "excepted a readable file " + path);
+        }
+        const auto bytes = static_cast<size_type>(status.st_size);
+        if (bytes < sizeof(Header))
+        {
+            throw std::runtime_error("excepted a yoshi::MappedMap in " + path);
+        }
+        void* p = ::mmap(nullptr, bytes, PROT_READ, MAP_SHARED | (populate ? MAP_POPULATE : 0), map.m_fd, 0);
+        if (p == MAP_FAILED)
+        {
+            throw std::system_error(errno, std::generic_category(), "excepted to map " + path);
+        }
+        map.m_base = static_cast<char*>(p);
+        map.m_mapped = bytes;
+        map.m_readOnly = true;
+        if (not map.isMapOf(bytes))
+        {
+            throw std::runtime_error("excepted a yoshi::MappedMap of the same types in " + path);
+        }
+        return map;
+    }
+
+    /// Builds a map on the heap from the image of a table (see image()) of
+    /// `bytes` bytes, `read(data, bytes)` copying the image to data. Throws if
+    /// the image is not a map of these key and value types.
+    template <typename Read>
+    static MappedMap fromImage(size_type bytes, Read&& read)
+    {
+        MappedMap map;
+        if (bytes < sizeof(Header))
+        {
+            throw std::runtime_error("excepted the image of a yoshi::MappedMap");
+        }
+        map.m_base = allocateHeap(bytes);
+        read(map.m_base, bytes);
+        if (not map.isMapOf(bytes))
+        {
+            throw std::runtime_error("excepted the image of a yoshi::MappedMap of the same types");
+        }
+        return map;
+    }
+
+    /// Beginning of the block holding the map, bytes() long, which can be
+    /// copied as is: it has no pointer
+    const char* image() const { return m_base; }
+
+    iterator begin() { return iterator(control(), slots(), 0, capacity()); }
+    const_iterator begin() const { return const_cast<MappedMap*>(this)->begin(); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(control(), slots(), capacity(), capacity()); }
+    const_iterator end() const { return const_cast<MappedMap*>(this)->end(); }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const { return size() == 0; }
+    size_type size() const { return m_base != nullptr ? header().size : 0; }
+    size_type capacity() const { return m_base != nullptr ? header().capacity : 0; }
+    size_type bucket_count() const { return capacity(); }
+    /// Bytes of the block (or of the file) holding the map
+    size_type bytes() const { return m_base != nullptr ? header().bytes : 0; }
+    bool readOnly() const { return m_readOnly; }
+    hasher hash_function() const { return m_hash; }
+    key_equal key_eq() const { return m_equal; }
+
+    iterator find(const K& key)
+    {
+        const auto index = findIndex(key);
+        return index != NONE ? iterator(control(), slots(), index, capacity()) : end();
+    }
+
+    const_iterator find(const K& key) const { return const_cast<MappedMap*>(this)->find(key); }
+    bool contains(const K& key) const { return findIndex(key) != NONE; }
+    size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+    {
+        checkWritable();
+        const auto found = findIndex(key);
+        if (found != NONE)
+        {
+            return {iterator(control(), slots(), found, capacity()), false};
+        }
+        if ((size() + erasedCount() + 1) * 4 > capacity() * 3)
+        {
+            grow();
+        }
+        const auto h = hashOf(key);
+        const auto mask = capacity() - 1;
+        auto index = h & mask;
+        while (control()[index] & FULL)
+        {
+            index = (index + 1) & mask;
+        }
+        auto& head = header();
+        head.erased -= (control()[index] == ERASED);
+        ++head.size;
+        control()[index] = tagOf(h);
+        new (&slots()[index]) value_type(key, V(std::forward<Args>(args)...));
+        return {iterator(control(), slots(), index, capacity()), true};
+    }
+
+    template <typename M>
+    std::pair<iterator, bool> insert_or_assign(const K& key, M&& value)
+    {
+        auto r = try_emplace(key, std::forward<M>(value));
+        if (not r.second)
+        {
+            r.first->second = std::forward<M>(value);
+        }
+        return r;
+    }
+
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+    size_type erase(const K& key)
+    {
+        checkWritable();
+        const auto index = findIndex(key);
+        if (index == NONE)
+        {
+            return 0;
+        }
+        // no probe sequence goes through the slot when the next one is empty
+        auto& head = header();
+        const bool last = control()[(index + 1) & (capacity() - 1)] == EMPTY;
+        control()[index] = last ? EMPTY : ERASED;
+        head.erased += not last;
+        --head.size;
+        return 1;
+    }
+
+    void clear()
+    {
+        checkWritable();
+        if (m_base != nullptr)
+        {
+            std::memset(control(), EMPTY, capacity());
+            header().size = 0;
+            header().erased = 0;
+        }
+    }
+
+    void reserve(size_type count)
+    {
+        if (capacityFor(count) > capacity())
+        {
+            rehashTo(capacityFor(count));
+        }
+    }
+
+    /// Rebuilds the table for max(count, size()) elements, dropping the erased slots
+    void rehash(size_type count)
+    {
+        rehashTo(capacityFor(std::max(count, size())));
+    }
+
+    void swap(MappedMap& other) noexcept
+    {
+        using std::swap;
+        swap(m_base, other.m_base);
+        swap(m_mapped, other.m_mapped);
+        swap(m_fd, other.m_fd);
+        swap(m_readOnly, other.m_readOnly);
+        swap(m_hash, other.m_hash);
+        swap(m_equal, other.m_equal);
+    }
+
+private:
+    static size_type capacityFor(size_type count)
+    {
+        size_type capacity = MIN_CAPACITY;
+        while (count * 4 > capacity * 3)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    static size_type alignUp(size_type offset) { return (offset + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT; }
+    static size_type controlOffset() { return alignUp(sizeof(Header)); }
+    static size_type slotsOffset(size_type capacity) { return alignUp(controlOffset() + capacity); }
+    static size_type bytesFor(size_type capacity) { return slotsOffset(capacity) + capacity * sizeof(value_type); }
+
+    static char* allocateHeap(size_type bytes)
+    {
+        return static_cast<char*>(::operator new(bytes, std::align_val_t(ALIGNMENT)));
+    }
+
+    Header& header() { return *reinterpret_cast<Header*>(m_base); }
+    const Header& header() const { return *reinterpret_cast<const Header*>(m_base); }
+    std::uint8_t* control() const
+    {
+        return m_base != nullptr ? reinterpret_cast<std::uint8_t*>(m_base + header().controlOffset) : nullptr;
+    }
+    value_type* slots() const
+    {
+        return m_base != nullptr ? reinterpret_cast<value_type*>(m_base + header().slotsOffset) : nullptr;
+    }
+    size_type erasedCount() const { return m_base != nullptr ? header().erased : 0; }
+
+    std::uint64_t hashOf(const K& key) const { return flat_map::mix(m_hash(key)); }
+    static std::uint8_t tagOf(std::uint64_t h) { return FULL | static_cast<std::uint8_t>(h >> 57); }
+
+    size_type findIndex(const K& key) const
+    {
+        if (capacity() == 0)
+        {
+            return NONE;
+        }
+        const auto h = hashOf(key);
+        const auto tag = tagOf(h);
+        const auto mask = capacity() - 1;
+        const auto* c = control();
+        const auto* s = slots();
+        // there is always an empty slot
+        for (auto index = h & mask; ; index = (index + 1) & mask)
+        {
+            if (c[index] == EMPTY)
+            {
+                return NONE;
+            }
+            if (c[index] == tag and m_equal(s[index].first, key))
+            {
+                return index;
+            }
+        }
+    }
+
+    /// Checks the header is the one of a map of these types in `bytes` bytes
+    bool isMapOf(size_type bytes) const
+    {
+        const auto& h = header();
+        return h.magic == MAGIC and h.version == VERSION and h.elementSize == sizeof(value_type) and
+               h.keySize == sizeof(K) and h.mappedSize == sizeof(V) and h.bytes == bytes;
+    }
+
+    void checkWritable() const
+    {
+        if (m_readOnly)
+        {
+            throw std::logic_error("excepted a writable yoshi::MappedMap, it is opened read only");
+        }
+    }
+
+    /// Writes the header and the empty control bytes of the block
+    void initialize(size_type capacity)
+    {
+        auto& head = header();
+        head.magic = MAGIC;
+        head.version = VERSION;
+        head.elementSize = sizeof(value_type);
+        head.keySize = sizeof(K);
+        head.mappedSize = sizeof(V);
+        head.capacity = capacity;
+        head.size = 0;
+        head.erased = 0;
+        head.controlOffset = controlOffset();
+        head.slotsOffset = slotsOffset(capacity);
+        head.bytes = bytesFor(capacity);
+        std::memset(control(), EMPTY, capacity);
+    }
+
+    /// Doubles the table, or only drops the erased slots when they use more
+    /// slots than the elements
+    void grow()
+    {
+        if (capacity() == 0)
+        {
+            rehashTo(MIN_CAPACITY);
+        }
+        else
+        {
+            rehashTo(size() + 1 > erasedCount() ? 2 * capacity() : capacity());
+        }
+    }
+
+    /// Moves the elements to a table of `capacity` slots, built on the heap and
+    /// copied in the file for the mapped maps
+    void rehashTo(size_type capacity)
+    {
+        checkWritable();
+        MappedMap table;
+        table.m_base = allocateHeap(bytesFor(capacity));
+        table.initialize(capacity);
+        for (auto it = begin(); it != end(); ++it)
+        {
+            const auto h = hashOf(it->first);
+            auto index = h & (capacity - 1);
+            while (table.control()[index] != EMPTY)
+            {
+                index = (index + 1) & (capacity - 1);
+            }
+            table.control()[index] = tagOf(h);
+            std::memcpy(static_cast<void*>(&table.slots()[index]), &*it, sizeof(value_type));
+        }
+        table.header().size = size();
+        if (m_fd < 0)
+        {
+            std::swap(m_base, table.m_base);
+            return;
+        }
+        resizeFile(table.header().bytes);
+        std::memcpy(m_base, table.m_base, table.header().bytes);
+    }
+
+    /// Resizes the file and maps it again read write
+    void resizeFile(size_type bytes)
+    {
+        if (m_base != nullptr)
+        {
+            ::munmap(m_base, m_mapped);
+            m_base = nullptr;
+        }
+        if (::ftruncate(m_fd, bytes) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "excepted to resize the file of the map");
+        }
+        void* p = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (p == MAP_FAILED)
+        {
+            throw std::system_error(errno, std::generic_category(), "excepted to map the file of the map");
+        }
+        m_base = static_cast<char*>(p);
+        m_mapped = bytes;
+    }
+
+    void release()
+    {
+        if (m_fd >= 0)
+        {
+            if (m_base != nullptr)
+            {
+                ::munmap(m_base, m_mapped);
+            }
+            ::close(m_fd);
+        }
+        else if (m_base != nullptr)
+        {
+            ::operator delete(m_base, std::align_val_t(ALIGNMENT));
+        }
+        m_base = nullptr;
+        m_fd = -1;
+    }
+
+    /// Header followed by the control bytes and the slots
+    char* m_base = nullptr;
+    /// Bytes mapped from the file
+    size_type m_mapped = 0;
+    /// File of the mapped maps, -1 on the heap
+    int m_fd = -1;
+    bool m_readOnly = false;
+    Hash m_hash;
+    KeyEqual m_equal;
+};
+
+}
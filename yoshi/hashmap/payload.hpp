@@ -0,0 +1,134 @@
+#pragma once
+
+#include "adapter.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+/// Trivially copyable value of N bytes, like the structs stored in the maps
+template <std::size_t N>
+struct Blob
+{
+    std::array<std::uint8_t, N> bytes;
+};
+
+/// Copies and moves of all the Tracked values
+struct PayloadCounts
+{
+    std::int64_t copies = 0;
+    std::int64_t moves = 0;
+};
+
+inline PayloadCounts& payloadCounts()
+{
+    static PayloadCounts s_counts;
+    return s_counts;
+}
+
+/// Value of N bytes which is not trivially movable: it counts its copies and
+/// moves (see payloadCounts)
+template <std::size_t N>
+struct Tracked
+{
+    Tracked() = default;
+
+    Tracked(const Tracked& other)
+        : bytes(other.bytes)
+    {
+        ++payloadCounts().copies;
+    }
+
+    Tracked(Tracked&& other) noexcept
+        : bytes(other.bytes)
+    {
+        ++payloadCounts().moves;
+    }
+
+    Tracked& operator=(const Tracked& other)
+    {
+        bytes = other.bytes;
+        ++payloadCounts().copies;
+        return *this;
+    }
+
+    Tracked& operator=(Tracked&& other) noexcept
+    {
+        bytes = other.bytes;
+        ++payloadCounts().moves;
+        return *this;
+    }
+
+    std::array<std::uint8_t, N> bytes{};
+};
+
+template <std::size_t N>
+struct ValueSelector<Blob<N>>
+{
+    static auto value()
+    {
+        Blob<N> blob;
+        blob.bytes.fill(42);
+        return blob;
+    }
+};
+
+template <std::size_t N>
+struct ValueSelector<Tracked<N>>
+{
+    static auto value()
+    {
+        Tracked<N> tracked;
+        tracked.bytes.fill(42);
+        return tracked;
+    }
+};
+
+template <typename V>
+struct IsTracked : std::false_type {};
+
+template <std::size_t N>
+struct IsTracked<Tracked<N>> : std::true_type {};
+
+/// Counts the copies and moves of the values between start() and stop() when
+/// they are Tracked, does nothing for the other values
+template <typename V>
+class MoveCounter
+{
+public:
+    void start()
+    {
+        if constexpr (IsTracked<V>::value)
+        {
+            m_start = payloadCounts();
+        }
+    }
+
+    void stop()
+    {
+        if constexpr (IsTracked<V>::value)
+        {
+            m_copies += payloadCounts().copies - m_start.copies;
+            m_moves += payloadCounts().moves - m_start.moves;
+        }
+    }
+
+    /// Adds the copies and moves per element to the user counters, `elements`
+    /// being the number of elements of all the counted regions
+    void report(benchmark::State& state, std::int64_t elements) const
+    {
+        if constexpr (IsTracked<V>::value)
+        {
+            state.counters["copies_per_element"] = static_cast<double>(m_copies) / elements;
+            state.counters["moves_per_element"] = static_cast<double>(m_moves) / elements;
+        }
+    }
+
+private:
+    PayloadCounts m_start;
+    std::int64_t m_copies = 0;
+    std::int64_t m_moves = 0;
+};
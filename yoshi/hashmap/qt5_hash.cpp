@@ -1,7 +1,20 @@
 #include "tests.hpp"
 
+#include <string>
+
+/// Hash of the std::string keys. QHash calls qHash unqualified: the argument
+/// dependent lookup would only search namespace std, where adding an overload
+/// is undefined, so it is declared in the namespace of QHash before its
+/// definition, for the lookup from its definition to find it.
+unsigned int qHash(const std::string& key, unsigned int seed = 0);
+
 #include <QHash>
 
+unsigned int qHash(const std::string& key, unsigned int seed)
+{
+    return qHash(QByteArray::fromRawData(key.data(), static_cast<int>(key.size())), seed);
+}
+
 /// Specialize the adapter for QHash since the interface
 /// does not follow most of the existing implementation!
 template<typename KeyType, typename ValueType>
@@ -11,13 +24,56 @@ struct Adapter<KeyType, ValueType, QHash>
     using Value = ValueType;
     using C = QHash<Key, Value>;
 
-    static auto insert(C& c, KeyType k, ValueType v) { return c.insert(k, v) != c.end();}
-    static auto erase(C& c, KeyType k) { return c.remove(k); }
-    static auto find(const C& c, KeyType k) { return c.find(k); }
+    static auto insert(C& c, const KeyType& k, const ValueType& v) { return c.insert(k, v) != c.end();}
+    static auto erase(C& c, const KeyType& k) { return c.remove(k); }
+    static bool update(C& c, const KeyType& k, const ValueType& v)
+    {
+        auto it = c.find(k);
+        if (it == c.end())
+        {
+            return false;
+        }
+        it.value() = v;
+        return true;
+    }
+    /// QHash has no emplace before Qt 6, its insert assigns existing keys
+    static bool emplace(C& c, const KeyType& k, const ValueType& v)
+    {
+        if (c.contains(k))
+        {
+            return false;
+        }
+        c.insert(k, v);
+        return true;
+    }
+    static bool tryEmplace(C& c, const KeyType& k, const ValueType& v) { return emplace(c, k, v); }
+    static bool insertOrAssign(C& c, const KeyType& k, const ValueType& v)
+    {
+        const bool inserted = not c.contains(k);
+        c.insert(k, v);
+        return inserted;
+    }
+    static void upsert(C& c, const KeyType& k, const ValueType& v) { c[k] = v; }
+    /// No node handles: removes then inserts `k`
+    static bool reinsert(C& c, const KeyType& k, const ValueType& v)
+    {
+        const bool inserted = c.remove(k) == 0;
+        c.insert(k, v);
+        return inserted;
+    }
+    static auto find(const C& c, const KeyType& k) { return c.find(k); }
+    template <typename L>
+    static auto findHeterogeneous(const C& c, const L& k) { return c.find(KeyType(k)); }
     static void reserve(C& c, std::size_t size) { c.reserve(size); }
     static void clear(C& c) { c.clear(); }
+    static std::size_t size(const C& c) { return c.size(); }
+    static std::size_t bucketCount(const C& c) { return c.capacity(); }
     static auto begin(C& c) { return c.begin(); }
     static auto end(C& c) { return c.end(); }
 };
 
+/// QHash allocates its nodes with malloc, not seen by the operator new
+template<typename KeyType, typename ValueType>
+struct TracksMemory<QHash<KeyType, ValueType>> : std::false_type {};
+
 DECLARE_ALL_TESTS(QHash)
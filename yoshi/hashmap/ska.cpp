@@ -3,3 +3,4 @@
 #include "thirdparties/skarupke/flat_hash_map.hpp"
 
 DECLARE_ALL_TESTS(ska::flat_hash_map)
+DECLARE_ALLOCATOR_TESTS(ska_flat_hash_map, ska::flat_hash_map)
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace yoshi::snapshot {
+
+/// Snapshot of a hashmap: a header followed either by the records, each key
+/// followed by its value as raw bytes, or by the image of the table of a map
+/// without pointers (see yoshi::MappedMap::image)
+struct Header
+{
+    std::uint64_t magic;
+    std::uint32_t format;
+    std::uint32_t keySize;
+    std::uint32_t valueSize;
+    std::uint32_t reserved;
+    /// elements of the map
+    std::uint64_t count;
+    /// bytes after the header
+    std::uint64_t bytes;
+};
+
+/// "yoshisnp" in little endian
+constexpr std::uint64_t MAGIC = 0x706e736968736f79;
+constexpr std::uint32_t RECORDS = 0;
+constexpr std::uint32_t IMAGE = 1;
+/// Bytes read or written at once from the files
+constexpr std::size_t CHUNK = 1 << 20;
+/// Bytes of records encoded or decoded at once, kept in the L2 cache
+constexpr std::size_t RECORDS_CHUNK = 64 << 10;
+
+/// Writes the snapshot in a buffer, which keeps its capacity from a snapshot
+/// to the next one
+class BufferWriter
+{
+public:
+    explicit BufferWriter(std::vector<char>& buffer)
+        : m_buffer(buffer)
+    {
+        m_buffer.clear();
+    }
+
+    void write(const void* data, std::size_t size)
+    {
+        const auto* p = static_cast<const char*>(data);
+        m_buffer.insert(m_buffer.end(), p, p + size);
+    }
+
+    void flush() {}
+
+private:
+    std::vector<char>& m_buffer;
+};
+
+/// Reads a snapshot from a buffer
+class BufferReader
+{
+public:
+    explicit BufferReader(const std::vector<char>& buffer)
+        : m_buffer(buffer)
+    {
+    }
+
+    void read(void* data, std::size_t size)
+    {
+        if (size > m_buffer.size() - m_offset)
+        {
+            throw std::runtime_error("excepted a complete snapshot");
+        }
+        std::memcpy(data, m_buffer.data() + m_offset, size);
+        m_offset += size;
+    }
+
+private:
+    const std::vector<char>& m_buffer;
+    std::size_t m_offset = 0;
+};
+
+/// Streams the snapshot to a file through a buffer of CHUNK bytes, so the
+/// snapshot is never in memory as a whole, the large writes (table images)
+/// going directly to the file
+class FileWriter
+{
+public:
+    explicit FileWriter(const std::string& path)
+        : m_fd(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644))
+        , m_chunk(new char[CHUNK])
+    {
+        if (m_fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "excepted a writable file " + path);
+        }
+    }
+
+    FileWriter(const FileWriter&) = delete;
+    FileWriter& operator=(const FileWriter&) = delete;
+
+    ~FileWriter()
+    {
+        ::close(m_fd);
+    }
+
+    void write(const void* data, std::size_t size)
+    {
+        const auto* p = static_cast<const char*>(data);
+        if (m_size == 0 and size >= CHUNK)
+        {
+            writeAll(p, size);
+            return;
+        }
+        while (size > 0)
+        {
+            const auto n = std::min(size, CHUNK - m_size);
+            std::memcpy(m_chunk.get() + m_size, p, n);
+            m_size += n;
+            p += n;
+            size -= n;
+            if (m_size == CHUNK)
+            {
+                flush();
+            }
+        }
+    }
+
+    /// Writes the end of the snapshot, to call before closing the file
+    void flush()
+    {
+        writeAll(m_chunk.get(), m_size);
+        m_size = 0;
+    }
+
+private:
+    void writeAll(const char* p, std::size_t size)
+    {
+        while (size > 0)
+        {
+            const auto n = ::write(m_fd, p, size);
+            if (n < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "excepted to write the snapshot");
+            }
+            p += n;
+            size -= n;
+        }
+    }
+
+    int m_fd;
+    std::unique_ptr<char[]> m_chunk;
+    std::size_t m_size = 0;
+};
+
+/// Streams a snapshot from a file through a buffer of CHUNK bytes, the large
+/// reads (table images) going directly to their destination
+class FileReader
+{
+public:
+    explicit FileReader(const std::string& path)
+        : m_fd(::open(path.c_str(), O_RDONLY))
+        , m_chunk(new char[CHUNK])
+    {
+        if (m_fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "excepted a readable file " + path);
+        }
+    }
+
+    FileReader(const FileReader&) = delete;
+    FileReader& operator=(const FileReader&) = delete;
+
+    ~FileReader()
+    {
+        ::close(m_fd);
+    }
+
+    void read(void* data, std::size_t size)
+    {
+        auto* p = static_cast<char*>(data);
+        const auto buffered = std::min(size, m_size - m_offset);
+        std::memcpy(p, m_chunk.get() + m_offset, buffered);
+        m_offset += buffered;
+        p += buffered;
+        size -= buffered;
+        if (size >= CHUNK)
+        {
+            readAll(p, size);
+            return;
+        }
+        if (size > 0)
+        {
+            m_size = readSome(m_chunk.get(), CHUNK, size);
+            std::memcpy(p, m_chunk.get(), size);
+            m_offset = size;
+        }
+    }
+
+private:
+    /// Reads at least `least` bytes and at most `size`, returns the bytes read
+    std::size_t readSome(char* p, std::size_t size, std::size_t least)
+    {
+        std::size_t done = 0;
+        while (done < least)
+        {
+            const auto n = ::read(m_fd, p + done, size - done);
+            if (n < 0)
+            {
+                throw std::system_error(errno, std::generic_category(), "excepted to read the snapshot");
+            }
+            if (n == 0)
+            {
+                throw std::runtime_error("excepted a complete snapshot");
+            }
+            done += n;
+        }
+        return done;
+    }
+
+    void readAll(char* p, std::size_t size) { readSome(p, size, size); }
+
+    int m_fd;
+    std::unique_ptr<char[]> m_chunk;
+    std::size_t m_size = 0;
+    std::size_t m_offset = 0;
+};
+
+/// Writes the `count` elements [first, last) as records, `key(it)` and
+/// `value(it)` giving the key and the value of an element
+template <typename K, typename V, typename Writer, typename It, typename Key, typename Value>
+void writeRecords(Writer& writer, std::size_t count, It first, It last, Key&& key, Value&& value)
+{
+    static_assert(std::is_trivially_copyable<K>::value and std::is_trivially_copyable<V>::value,
+                  "the records are raw bytes");
+    constexpr std::size_t RECORD = sizeof(K) + sizeof(V);
+    const Header header{MAGIC, RECORDS, sizeof(K), sizeof(V), 0, count, count * RECORD};
+    writer.write(&header, sizeof(header));
+    std::vector<char> chunk(std::max<std::size_t>(RECORDS_CHUNK / RECORD, 1) * RECORD);
+    char* p = chunk.data();
+    for (; first != last; ++first)
+    {
+        std::memcpy(p, &key(first), sizeof(K));
+        std::memcpy(p + sizeof(K), &value(first), sizeof(V));
+        p += RECORD;
+        if (p == chunk.data() + chunk.size())
+        {
+            writer.write(chunk.data(), chunk.size());
+            p = chunk.data();
+        }
+    }
+    writer.write(chunk.data(), p - chunk.data());
+}
+
+/// Writes the image of a table of `bytes` bytes holding `count` elements
+template <typename K, typename V, typename Writer>
+void writeImage(Writer& writer, std::size_t count, const void* image, std::size_t bytes)
+{
+    const Header header{MAGIC, IMAGE, sizeof(K), sizeof(V), 0, count, bytes};
+    writer.write(&header, sizeof(header));
+    writer.write(image, bytes);
+}
+
+/// Reads the header of a snapshot of K and V
+template <typename K, typename V, typename Reader>
+Header readHeader(Reader& reader)
+{
+    Header header;
+    reader.read(&header, sizeof(header));
+    if (header.magic != MAGIC or header.keySize != sizeof(K) or header.valueSize != sizeof(V))
+    {
+        throw std::runtime_error("excepted a snapshot of the same key and value types");
+    }
+    return header;
+}
+
+/// Reads the records following `header` by chunks and calls `f(key, value)` on each one
+template <typename K, typename V, typename Reader, typename F>
+void readRecords(Reader& reader, const Header& header, F&& f)
+{
+    if (header.format != RECORDS)
+    {
+        throw std::runtime_error("excepted a snapshot made of records");
+    }
+    constexpr std::size_t RECORD = sizeof(K) + sizeof(V);
+    constexpr std::size_t PER_CHUNK = std::max<std::size_t>(RECORDS_CHUNK / RECORD, 1);
+    std::vector<char> chunk(PER_CHUNK * RECORD);
+    for (std::uint64_t done = 0; done < header.count; )
+    {
+        const auto n = std::min<std::uint64_t>(PER_CHUNK, header.count - done);
+        reader.read(chunk.data(), n * RECORD);
+        for (const char* p = chunk.data(); p != chunk.data() + n * RECORD; p += RECORD)
+        {
+            K key;
+            V value;
+            std::memcpy(&key, p, sizeof(K));
+            std::memcpy(&value, p + sizeof(K), sizeof(V));
+            f(key, value);
+        }
+        done += n;
+    }
+}
+
+}
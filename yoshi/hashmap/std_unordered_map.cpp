@@ -1,5 +1,9 @@
 #include "tests.hpp"
 
+#include "yoshi/hash/hashers.hpp"
+
 #include <unordered_map>
 
 DECLARE_ALL_TESTS(std::unordered_map)
+DECLARE_ALLOCATOR_TESTS(std_unordered_map, std::unordered_map)
+DECLARE_ALL_TESTS_WITH_HASHER(std_unordered_map_wyhash, std::unordered_map, yoshi::WyHash)
@@ -1,14 +1,32 @@
 #pragma once
 
 #include "adapter.hpp"
+#include "cache.hpp"
+#include "distribution.hpp"
+#include "fenwick_tree.hpp"
+#include "payload.hpp"
+#include "snapshot.hpp"
 #include "traits.hpp"
 
+#include "yoshi/allocator.hpp"
+#include "yoshi/harness.hpp"
+#include "yoshi/latency.hpp"
+#include "yoshi/memory.hpp"
+#include "yoshi/perf_counters.hpp"
+#include "yoshi/timeline.hpp"
+#include "yoshi/trace.hpp"
 #include "yoshi/yoshi.hpp"
 
 #include <algorithm>
 #include <random>
 #include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
+#include <optional>
+#include <string_view>
+
+#include <unistd.h>
 
 /// Inserts [0, state.range(0) -1] in sequential order
 template <typename K, typename V, template<typename ...> typename H>
@@ -16,19 +34,33 @@ void Insert_Sequential(benchmark::State& state)
 {
     using AdapterT = Adapter<K, V, H>;
     using Type = typename AdapterT::C;
-    Type c;
     const auto value = ValueSelector<V>::value();
-    for(auto _ : state)
-    {
-        state.PauseTiming();
-        AdapterT::clear(c);
-        AdapterT::reserve(c, state.range(0));
-        state.ResumeTiming();
-        for (K i= 0; i < state.range(0); ++i)
+    yoshi::runBatched<Type>(state, state.range(0),
+        [&](Type& c)
         {
-            AdapterT::insert(c, i, value);
-        }
+            AdapterT::clear(c);
+            AdapterT::reserve(c, state.range(0));
+        },
+        [&](Type& c, auto recording)
+        {
+            for (K i= 0; i < state.range(0); ++i)
+            {
+                yoshi::latency::record(recording, [&] { return AdapterT::insert(c, i, value); });
+            }
+        },
+        [](Type&) {});
+}
+
+/// Fills keys with [0, count -1] in a random order
+template <typename K>
+void shuffledKeys(std::vector<K>& keys, int64_t count, std::mt19937_64& generator)
+{
+    keys.clear();
+    for(K i = 0; i < count; ++i)
+    {
+        keys.push_back(i);
     }
+    std::shuffle(keys.begin(), keys.end(), generator);
 }
 
 /// Inserts [0, state.range(0) -1] in random order
@@ -37,31 +69,33 @@ static void Insert_Random(benchmark::State& state)
 {
     using AdapterT = Adapter<K, V, H>;
     using Type = typename AdapterT::C;
-    Type c;
+    struct Instance
+    {
+        Type c;
+        std::vector<K> keys;
+    };
     auto value = ValueSelector<V>::value();
-    std::vector<K> keys;
-    keys.reserve(state.range(0));
     const std::int64_t SEED = 0;
     std::mt19937_64 generator(SEED);
-    for(auto _ : state)
-    {
-        state.PauseTiming();
-        keys.clear();
-        for(K i = 0; i < state.range(0); ++i)
+    MoveCounter<V> moves;
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
         {
-            keys.push_back(i);
-        }
-        std::shuffle(keys.begin(), keys.end(), generator);
-
-        AdapterT::clear(c);
-        AdapterT::reserve(c, state.range(0));
-        state.ResumeTiming();
-        for (K i = 0; i < state.range(0); ++i)
+            shuffledKeys(instance.keys, state.range(0), generator);
+            AdapterT::clear(instance.c);
+            AdapterT::reserve(instance.c, state.range(0));
+        },
+        [&](Instance& instance, auto recording)
         {
-            auto key = keys[i];
-            AdapterT::insert(c, key, value);
-        }
-    }
+            moves.start();
+            for (auto key : instance.keys)
+            {
+                yoshi::latency::record(recording, [&] { return AdapterT::insert(instance.c, key, value); });
+            }
+            moves.stop();
+        },
+        [](Instance&) {});
+    moves.report(state, state.iterations() * state.range(0));
 }
 
 /// Inserts [0, state.range(0) -1] in sequential order and measure the time
@@ -71,23 +105,25 @@ static void Erase_Sequential(benchmark::State& state)
 {
     using AdapterT = Adapter<K, V, H>;
     using Type = typename AdapterT::C;
-    Type c;
     auto value = ValueSelector<V>::value();
-    for(auto _ : state)
-    {
-        state.PauseTiming();
-        AdapterT::clear(c);
-        AdapterT::reserve(c, state.range(0));
-        for (K i= 0; i < state.range(0); ++i)
+    yoshi::runBatched<Type>(state, state.range(0),
+        [&](Type& c)
         {
-            AdapterT::insert(c, i, value);
-        }
-        state.ResumeTiming();
-        for (K i= 0; i < state.range(0); ++i)
+            AdapterT::clear(c);
+            AdapterT::reserve(c, state.range(0));
+            for (K i= 0; i < state.range(0); ++i)
+            {
+                AdapterT::insert(c, i, value);
+            }
+        },
+        [&](Type& c, auto recording)
         {
-            AdapterT::erase(c, i);
-        }
-    }
+            for (K i= 0; i < state.range(0); ++i)
+            {
+                yoshi::latency::record(recording, [&] { return AdapterT::erase(c, i); });
+            }
+        },
+        [](Type&) {});
 }
 
 /// Inserts [0, state.range(0) -1] in random order and measure the time
@@ -97,36 +133,49 @@ static void Erase_Random(benchmark::State& state)
 {
     using AdapterT = Adapter<K, V, H>;
     using Type = typename AdapterT::C;
-    Type c;
+    struct Instance
+    {
+        Type c;
+        std::vector<K> keys;
+    };
     auto value = ValueSelector<V>::value();
-    std::vector<K> keys;
-    keys.reserve(state.range(0));
     const std::int64_t SEED = 0;
     std::mt19937_64 generator(SEED);
-    for(auto _ : state)
-    {
-        state.PauseTiming();
-        keys.clear();
-        for(K i = 0; i < state.range(0); ++i)
-        {
-            keys.push_back(i);
-        }
-        std::shuffle(keys.begin(), keys.end(), generator);
-        AdapterT::clear(c);
-        AdapterT::reserve(c, state.range(0));
-        for (K i= 0; i < state.range(0); ++i)
+    MoveCounter<V> moves;
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
         {
-            auto key = keys[i];
-            AdapterT::insert(c, key, value);
-        }
-        // shuffle again
-        std::shuffle(keys.begin(), keys.end(), generator);
-        state.ResumeTiming();
-        for (K i= 0; i < state.range(0); ++i)
+            shuffledKeys(instance.keys, state.range(0), generator);
+            AdapterT::clear(instance.c);
+            AdapterT::reserve(instance.c, state.range(0));
+            for (auto key : instance.keys)
+            {
+                AdapterT::insert(instance.c, key, value);
+            }
+            // shuffle again
+            std::shuffle(instance.keys.begin(), instance.keys.end(), generator);
+        },
+        [&](Instance& instance, auto recording)
         {
-            auto key = keys[i];
-            AdapterT::erase(c, key);
-        }
+            moves.start();
+            for (auto key : instance.keys)
+            {
+                yoshi::latency::record(recording, [&] { return AdapterT::erase(instance.c, key); });
+            }
+            moves.stop();
+        },
+        [](Instance&) {});
+    moves.report(state, state.iterations() * state.range(0));
+}
+
+/// Throws if `found` is not the number of keys `expected` to be found
+inline void checkFound(int64_t expected, int64_t found)
+{
+    if (found != expected)
+    {
+        std::string error = std::string("excepted ") + std::to_string(expected);
+        error += std::string(" got ") + std::to_string(found);
+        throw std::runtime_error(error);
     }
 }
 
@@ -137,84 +186,76 @@ static void Find_Sequential(benchmark::State& state)
 {
     using AdapterT = Adapter<K, V, H>;
     using Type = typename AdapterT::C;
-    Type c;
-    auto value = ValueSelector<V>::value();
-
-    for(auto _ : state)
+    struct Instance
     {
-        state.PauseTiming();
-        AdapterT::clear(c);
-        AdapterT::reserve(c, state.range(0));
-        for (K i= 0; i < state.range(0); ++i)
-        {
-            AdapterT::insert(c, i, value);
-        }
+        Type c;
         int64_t found = 0;
-        state.ResumeTiming();
-        for (K i= 0; i < state.range(0); ++i)
+    };
+    auto value = ValueSelector<V>::value();
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
         {
-            auto it = AdapterT::find(c, i);
-            found += (it != AdapterT::end(c));
-        }
-        state.PauseTiming();
-        if (found != state.range(0))
+            AdapterT::clear(instance.c);
+            AdapterT::reserve(instance.c, state.range(0));
+            for (K i= 0; i < state.range(0); ++i)
+            {
+                AdapterT::insert(instance.c, i, value);
+            }
+            instance.found = 0;
+        },
+        [&](Instance& instance, auto recording)
         {
-            std::string error = std::string("excepted ") + std::to_string(state.range(0));
-            error += std::string(" got ") + std::to_string(found);
-            throw std::runtime_error(error);
-        }
-        state.ResumeTiming();
-    }
+            for (K i= 0; i < state.range(0); ++i)
+            {
+                auto it = yoshi::latency::record(recording, [&] { return AdapterT::find(instance.c, i); });
+                instance.found += (it != AdapterT::end(instance.c));
+            }
+        },
+        [&](Instance& instance) { checkFound(state.range(0), instance.found); });
 }
 
 /// Inserts [0, state.range(0) -1] in random order and measure the time
-/// to do the find in [0, state.range(0) -1] in a random order (different from insert)
-template <typename K, typename V, template<typename ...> typename H>
+/// to do state.range(0) finds with keys from the distribution (by default
+/// [0, state.range(0) -1] in a random order different from insert)
+template <typename K, typename V, template<typename ...> typename H, typename Dist = UniformKeys>
 static void Find_Random(benchmark::State& state)
 {
     using AdapterT = Adapter<K, V, H>;
     using Type = typename AdapterT::C;
-    Type c;
+    struct Instance
+    {
+        Type c;
+        std::vector<K> lookups;
+        int64_t found = 0;
+    };
     auto value = ValueSelector<V>::value();
     std::vector<K> keys;
     keys.reserve(state.range(0));
     const std::int64_t SEED = 0;
     std::mt19937_64 generator(SEED);
-    for(auto _ : state)
-    {
-        state.PauseTiming();
-        keys.clear();
-        for(K i = 0; i < state.range(0); ++i)
-        {
-            keys.push_back(i);
-        }
-        std::shuffle(keys.begin(), keys.end(), generator);
-        AdapterT::clear(c);
-        AdapterT::reserve(c, state.range(0));
-        for (K i= 0; i < state.range(0); ++i)
+    Dist distribution(state.range(0), generator);
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
         {
-            auto key = keys[i];
-            AdapterT::insert(c, key, value);
-        }
-        // shuffle again
-        std::shuffle(keys.begin(), keys.end(), generator);
-        int64_t found = 0;
-        state.ResumeTiming();
-        for (K i= 0; i < state.range(0); ++i)
-        {
-            auto key = keys[i];
-            auto it = AdapterT::find(c, key);
-            found += (it != AdapterT::end(c));
-        }
-        state.PauseTiming();
-        if (found != state.range(0))
+            shuffledKeys(keys, state.range(0), generator);
+            AdapterT::clear(instance.c);
+            AdapterT::reserve(instance.c, state.range(0));
+            for (auto key : keys)
+            {
+                AdapterT::insert(instance.c, key, value);
+            }
+            generateKeys(instance.lookups, distribution, state.range(0), state.range(0), generator);
+            instance.found = 0;
+        },
+        [&](Instance& instance, auto recording)
         {
-            std::string error = std::string("excepted ") + std::to_string(state.range(0));
-            error += std::string(" got ") + std::to_string(found);
-            throw std::runtime_error(error);
-        }
-        state.ResumeTiming();
-    }
+            for (auto key : instance.lookups)
+            {
+                auto it = yoshi::latency::record(recording, [&] { return AdapterT::find(instance.c, key); });
+                instance.found += (it != AdapterT::end(instance.c));
+            }
+        },
+        [&](Instance& instance) { checkFound(state.range(0), instance.found); });
 }
 
 enum class Type : uint8_t
@@ -237,124 +278,261 @@ struct Action
 template<typename T>
 using Actions = std::vector<Action<T>>;
 
+/// Generates 2 * count actions: the keys [0, count) are inserted in a random order,
+/// and each one is erased at a random position after its insertion.
+///
+/// The erasures are placed one by one in the sequence in O(n log n). Only the number
+/// of erasures in each gap between two insertions is needed to find the position of
+/// an insertion, so a first pass chooses the gap of each erasure and its index in
+/// the gap at that time, then a second pass orders the erasures of each gap from the
+/// last one placed, which keeps its index, to the first one.
 template<typename T>
 Actions<T> generateRandomActions(int64_t count)
 {
     const std::int64_t SEED = 0;
     std::mt19937_64 generator(SEED);
+    Actions<T> inserts;
+    inserts.reserve(count);
+    for(int64_t i = 0; i < count; ++i)
+    {
+        inserts.push_back(Action<T>{static_cast<T>(i), Type::NEW});
+    }
+    std::shuffle(inserts.begin(), inserts.end(), generator);
+    std::vector<std::uint32_t> insertIndex(count);
+    for(int64_t k = 0; k < count; ++k)
+    {
+        insertIndex[inserts[k].id] = static_cast<std::uint32_t>(k);
+    }
+    // the gap k is before the k-th insertion, the gap count at the end
+    yoshi::FenwickTree gaps(count + 1);
+    std::vector<std::uint32_t> gapSizes(count + 1, 0);
+    std::vector<std::uint32_t> eraseGap(count);
+    std::vector<std::uint32_t> eraseIndex(count);
+    std::uniform_int_distribution<T> distribution(1, count);
+    for(int64_t i = 0; i < count; ++i)
+    {
+        const int64_t size = count + i;
+        const int64_t k = insertIndex[i];
+        const int64_t position = k + gaps.prefix(k + 1);
+        // the insertion is searched from the position i only: when it is before, the
+        // erasure is appended at the end (kept to generate the same sequences as before)
+        const int64_t maxRandom = position < i ? 0 : size - position;
+        const int64_t erasePosition = maxRandom <= 1 ? size : position + 1 + (distribution(generator) % maxRandom);
+        // the first gap g such that g + gaps.prefix(g + 1) >= erasePosition
+        const auto [gap, before] = gaps.search([&](std::size_t c, std::int64_t sum)
+        {
+            return static_cast<int64_t>(c) + sum <= erasePosition;
+        });
+        eraseGap[i] = static_cast<std::uint32_t>(gap);
+        eraseIndex[i] = static_cast<std::uint32_t>(erasePosition - gap - before);
+        gaps.add(gap, 1);
+        ++gapSizes[gap];
+    }
+    std::vector<std::uint32_t> gapStart(count + 1, 0);
+    for(int64_t g = 0; g < count; ++g)
+    {
+        gapStart[g + 1] = gapStart[g] + gapSizes[g];
+    }
+    yoshi::FenwickTree freeSlots(count, 1);
+    std::vector<std::uint32_t> erases(count);
+    for(int64_t i = count - 1; i >= 0; --i)
+    {
+        const int64_t rank = freeSlots.prefix(gapStart[eraseGap[i]]) + eraseIndex[i];
+        const auto slot = freeSlots.search([&](std::size_t, std::int64_t sum) { return sum <= rank; }).first;
+        freeSlots.add(slot, -1);
+        erases[slot] = static_cast<std::uint32_t>(i);
+    }
+    Actions<T> result;
+    result.reserve(2 * count);
+    auto erase = erases.begin();
+    for(int64_t g = 0; g <= count; ++g)
+    {
+        for(auto end = erase + gapSizes[g]; erase != end; ++erase)
+        {
+            result.push_back(Action<T>{static_cast<T>(*erase), Type::DELETE});
+        }
+        if (g < count)
+        {
+            result.push_back(inserts[g]);
+        }
+    }
+    return result;
+}
+
+/// Generates 2 * count actions with keys drawn from the distribution over [0, count):
+/// a key which is not in the map is inserted, else it is erased.
+template<typename T, typename Dist>
+Actions<T> generateSkewedActions(int64_t count)
+{
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    Dist distribution(count, generator);
+    std::vector<bool> live(count, false);
     Actions<T> result;
     result.reserve(2 * count);
-    for(int i = 0; i < count; ++i)
+    for(int64_t i = 0; i < 2 * count; ++i)
     {
-        result.push_back(Action<T>{i, Type::NEW});
+        const T id = distribution(generator);
+        result.push_back(Action<T>{id, live[id] ? Type::DELETE : Type::NEW});
+        live[id] = not live[id];
     }
-    std::shuffle(result.begin(), result.end(), generator);
-    std::uniform_int_distribution<T> distribution(1, count);
-    for(int i = 0; i < count; ++i)
+    return result;
+}
+
+/// Returns the actions of the distribution for count keys. Only the actions of
+/// the last size are kept, reused by the next benchmark of the same size, so the
+/// actions of all the sizes do not stay in memory
+template<typename T, typename Dist>
+const Actions<T>& generateActions(int64_t count)
+{
+    static int64_t s_count = -1;
+    static Actions<T> s_actions;
+    if (count != s_count)
     {
-        auto it = std::find(result.begin() + i, result.end(), Action<T>{i, Type::NEW});
-        auto maxRandom = std::distance(it, result.end());
-        if (maxRandom <= 1)
+        // freed before generating the next ones
+        Actions<T>().swap(s_actions);
+        s_count = -1;
+        if constexpr (Dist::permutation)
         {
-            result.push_back(Action<T>{i, Type::DELETE});
+            s_actions = generateRandomActions<T>(count);
         }
         else
         {
-
-            auto insertIt = it + 1 + (distribution(generator) % maxRandom);
-            result.insert(insertIt, Action<T>{i, Type::DELETE});
+            s_actions = generateSkewedActions<T, Dist>(count);
         }
+        s_count = count;
     }
-    return result;
+    return s_actions;
 }
 
-template <typename K, template<typename ...> typename H>
+template <typename K, template<typename ...> typename H, typename Dist = UniformKeys>
 static void Insert_Erase_Random(benchmark::State& state)
 {
     using AdapterT = Adapter<K, Action<K>, H>;
     using CType = typename AdapterT::C;
-    CType c;
-    auto actions = generateRandomActions<K>(state.range(0));
-    for(auto _ : state)
+    struct Instance
     {
-        state.PauseTiming();
-        AdapterT::clear(c);
-        AdapterT::reserve(c, state.range(0));
+        CType c;
         int64_t inserted = 0;
         int64_t deleted = 0;
-        state.ResumeTiming();
-        for (auto& action : actions)
+    };
+    const auto& actions = generateActions<K, Dist>(state.range(0));
+    const int64_t expectedInserts = std::count_if(actions.begin(), actions.end(),
+        [](const auto& action) { return action.type == Type::NEW; });
+    const int64_t expectedErases = actions.size() - expectedInserts;
+    // the counters are per action, an insert and an erase per key
+    yoshi::PerfCounters::instance().setOperations(actions.size());
+    yoshi::runBatched<Instance>(state, actions.size(),
+        [&](Instance& instance)
+        {
+            AdapterT::clear(instance.c);
+            AdapterT::reserve(instance.c, state.range(0));
+            instance.inserted = 0;
+            instance.deleted = 0;
+        },
+        [&](Instance& instance, auto recording)
         {
-            if (action.type == Type::NEW)
+            for (auto& action : actions)
             {
-                inserted += AdapterT::insert(c, action.id, action);
+                if (action.type == Type::NEW)
+                {
+                    instance.inserted += yoshi::latency::record(recording, [&] { return AdapterT::insert(instance.c, action.id, action); });
+                }
+                else if (action.type == Type::DELETE)
+                {
+                    instance.deleted += yoshi::latency::record(recording, [&] { return AdapterT::erase(instance.c, action.id); });
+                }
             }
-            else if (action.type == Type::DELETE)
+        },
+        [&](Instance& instance)
+        {
+            if ((instance.inserted != expectedInserts) or (instance.deleted != expectedErases))
             {
-                deleted += AdapterT::erase(c, action.id);
+                std::string error = std::string("excepted ") + std::to_string(expectedInserts);
+                error += std::string(" , ") + std::to_string(expectedErases);
+                error += std::string(" got ") + std::to_string(instance.inserted);
+                error += std::string(" , ") + std::to_string(instance.deleted);
+                throw std::runtime_error(error);
             }
-        }
-        state.PauseTiming();
-        if ((inserted != state.range(0)) or (deleted != state.range(0)))
+        });
+}
+
+/// Applies the sizes of the run, then 1M, 10M and 100M out of the short mode: the
+/// actions are generated in O(n log n), once per size for all the implementations
+inline void insertEraseArgs(benchmark::internal::Benchmark* b, const std::vector<int64_t>& sizes)
+{
+    for (auto size : sizes)
+    {
+        b->Arg(size);
+    }
+    if (not yoshi::options().shortRun)
+    {
+        for (int64_t size : {1000000, 10000000, 100000000})
         {
-            std::string error = std::string("excepted ") + std::to_string(state.range(0));
-            error += std::string(" got ") + std::to_string(inserted);
-            error += std::string(" , ") + std::to_string(deleted);
-            throw std::runtime_error(error);
+            b->Arg(size);
         }
-        state.ResumeTiming();
     }
 }
 
-template <typename K, typename V, template<typename ...> typename H>
+/// Inserts half of [0, state.range(0) -1] in random order and measure the time
+/// to do state.range(0) finds with keys from the distribution (by default all
+/// the keys of [0, state.range(0) -1] so half of the finds are hits)
+template <typename K, typename V, template<typename ...> typename H, typename Dist = UniformKeys>
 void Find_HalfHit(benchmark::State& state)
 {
     using AdapterT = Adapter<K, V, H>;
     using Type = typename AdapterT::C;
-    Type c;
+    struct Instance
+    {
+        Type c;
+        std::vector<K> lookups;
+        int64_t expected = 0;
+        int64_t found = 0;
+    };
     const auto value = ValueSelector<V>::value();
 
     std::vector<K> keys;
+    std::vector<bool> present;
     keys.reserve(state.range(0));
     const std::int64_t SEED = 0;
     std::mt19937_64 generator(SEED);
+    Dist distribution(state.range(0), generator);
 
-    for(auto _: state)
-    {
-        state.PauseTiming();
-        keys.clear();
-        for(K i = 0; i < state.range(0); ++i)
-        {
-            keys.push_back(i);
-        }
-        std::shuffle(keys.begin(), keys.end(), generator);
-        AdapterT::clear(c);
-        AdapterT::reserve(c, state.range(0));
-        int64_t inserted = 0;
-        for (K i = 0; i < state.range(0); i += 2)
-        {
-            auto key = keys[i];
-            AdapterT::insert(c, key, value);
-            inserted++;
-        }
-
-        state.ResumeTiming();
-        int64_t found = 0;
-        for (K i = 0; i < state.range(0); ++i)
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
         {
-            auto key = keys[i];
-            auto it = AdapterT::find(c, key);
-            found += (it != AdapterT::end(c));
-        }
-        state.PauseTiming();
-        if (found != inserted)
+            shuffledKeys(keys, state.range(0), generator);
+            AdapterT::clear(instance.c);
+            AdapterT::reserve(instance.c, state.range(0));
+            present.assign(state.range(0), false);
+            for (K i = 0; i < state.range(0); i += 2)
+            {
+                auto key = keys[i];
+                AdapterT::insert(instance.c, key, value);
+                present[key] = true;
+            }
+            if constexpr (Dist::permutation)
+            {
+                // same order as the insert: hits and misses alternate
+                instance.lookups = keys;
+            }
+            else
+            {
+                generateKeys(instance.lookups, distribution, state.range(0), state.range(0), generator);
+            }
+            instance.expected = std::count_if(instance.lookups.begin(), instance.lookups.end(),
+                [&present](K key) { return present[key]; });
+            instance.found = 0;
+        },
+        [&](Instance& instance, auto recording)
         {
-            std::string error = std::string("excepted ") + std::to_string(inserted);
-            error += std::string("got ") + std::to_string(found);
-            throw std::runtime_error(error);
-        }
-        state.ResumeTiming();
-    }
+            for (auto key : instance.lookups)
+            {
+                auto it = yoshi::latency::record(recording, [&] { return AdapterT::find(instance.c, key); });
+                instance.found += (it != AdapterT::end(instance.c));
+            }
+        },
+        [](Instance& instance) { checkFound(instance.expected, instance.found); });
 }
 
 template <typename K, typename V, template<typename ...> typename H>
@@ -362,64 +540,61 @@ void Find_Miss(benchmark::State& state)
 {
     using AdapterT = Adapter<K, V, H>;
     using Type = typename AdapterT::C;
-    Type c;
+    struct Instance
+    {
+        Type c;
+        std::vector<K> missing;
+        int64_t found = 0;
+    };
     const auto value = ValueSelector<V>::value();
 
     std::vector<K> keys;
-    std::vector<K> missing;
     keys.reserve(state.range(0));
-    missing.reserve(state.range(0));
     const std::int64_t SEED = 0;
     std::mt19937_64 generator(SEED);
 
-    for(auto _: state)
-    {
-        state.PauseTiming();
-        keys.clear();
-        missing.clear();
-        for(K i = 0; i < state.range(0); ++i)
+    yoshi::runBatched<Instance>(state, state.range(0) / 2,
+        [&](Instance& instance)
         {
-            keys.push_back(i);
-        }
-        std::shuffle(keys.begin(), keys.end(), generator);
-        AdapterT::clear(c);
-        AdapterT::reserve(c, state.range(0));
-        int64_t inserted = 0;
-        for (K i = 0; i < state.range(0); i++)
-        {
-            const bool isEven = (i%2 == 0);
-            if (isEven)
+            shuffledKeys(keys, state.range(0), generator);
+            AdapterT::clear(instance.c);
+            AdapterT::reserve(instance.c, state.range(0));
+            instance.missing.clear();
+            for (K i = 0; i < state.range(0); i++)
             {
-                auto key = keys[i];
-                AdapterT::insert(c, key, value);
-                inserted++;
+                const bool isEven = (i%2 == 0);
+                if (isEven)
+                {
+                    AdapterT::insert(instance.c, keys[i], value);
+                }
+                else
+                {
+                    instance.missing.push_back(keys[i]);
+                }
             }
-            else
+            instance.found = 0;
+        },
+        [&](Instance& instance, auto recording)
+        {
+            for (auto k: instance.missing)
             {
-                missing.push_back(keys[i]);
+                auto it = yoshi::latency::record(recording, [&] { return AdapterT::find(instance.c, k); });
+                instance.found += (it != AdapterT::end(instance.c));
             }
-        }
-        state.ResumeTiming();
-        int64_t found = 0;
-        for (auto k: missing)
-        {
-            auto it = AdapterT::find(c, k);
-            found += (it != AdapterT::end(c));
-        }
-        state.PauseTiming();
-        if (found != 0)
+        },
+        [](Instance& instance)
         {
-            throw std::runtime_error("should not be able to find any element");
-        }
-        state.ResumeTiming();
-    }
+            if (instance.found != 0)
+            {
+                throw std::runtime_error("should not be able to find any element");
+            }
+        });
 }
 
 template <typename K, typename V, template<typename ...> typename H>
 void Rehash_Impl(benchmark::State& state, std::true_type)
 {
     using AdapterT = Adapter<K, V, H>;
-    using TraitsT = Traits<K, V, H>;
     using Type = typename AdapterT::C;
 
     Type c;
@@ -431,74 +606,1541 @@ void Rehash_Impl(benchmark::State& state, std::true_type)
         AdapterT::insert(c, i, value);
     }
     // benchmark : we can just do a rehash
+    MoveCounter<V> moves;
     for(auto _: state)
     {
+        moves.start();
+        yoshi::PerfCounters::instance().start();
+        const auto start = std::chrono::steady_clock::now();
         AdapterT::unconditionalRehash(c);
         benchmark::ClobberMemory();
+        const auto end = std::chrono::steady_clock::now();
+        yoshi::PerfCounters::instance().stop();
+        moves.stop();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
     }
+    moves.report(state, state.iterations() * state.range(0));
 }
 
+/// Without an unconditional rehash, times the insert growing a map reserved
+/// for state.range(0) elements: the one changing its bucket count, found on a
+/// first map, the previous inserts being untimed
 template <typename K, typename V, template<typename ...> typename H>
 void Rehash_Impl(benchmark::State& state, std::false_type)
 {
-    // If the container does not support unconditionalRehash then
-    // the easiest way to mesure the rehash is to look for a costly insert...
     using AdapterT = Adapter<K, V, H>;
-    using TraitsT = Traits<K, V, H>;
     using Type = typename AdapterT::C;
 
-    Type c;
-    AdapterT::reserve(c, state.range(0));
     const auto value = ValueSelector<V>::value();
-    // generate dataset
-    const auto offset = state.range(0) - 5;
-    for(K i = 0; i < offset; ++i)
-    {
-        AdapterT::insert(c, i, value);
-    }
-
-    for (auto _: state)
+    // number of elements in the map when it grows
+    K growth = 0;
     {
-        // copy
-        auto copy = c;
-        int64_t current_time = 0;
-        int64_t max_time = 0;
-        int i = 0;
-        do {
-            // filter out 5 first values
-            if (i > 5)
+        Type c;
+        AdapterT::reserve(c, state.range(0));
+        const auto buckets = AdapterT::bucketCount(c);
+        while (AdapterT::bucketCount(c) == buckets)
+        {
+            if (growth > 4 * state.range(0))
             {
-                max_time = std::max(current_time, max_time);
+                state.SkipWithError("the map does not grow");
+                return;
             }
-            auto start = std::chrono::high_resolution_clock::now();
-            AdapterT::insert(copy, i + offset, value);
-            auto end   = std::chrono::high_resolution_clock::now();
-            ++i;
-            current_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                    end - start).count();
-        } while (i < 5 || current_time * 25 > max_time);
+            AdapterT::insert(c, growth++, value);
+        }
+        --growth;
+    }
 
-        state.SetIterationTime(max_time);
+    MoveCounter<V> moves;
+    for (auto _ : state)
+    {
+        Type c;
+        AdapterT::reserve(c, state.range(0));
+        for (K i = 0; i < growth; ++i)
+        {
+            AdapterT::insert(c, i, value);
+        }
+        const auto buckets = AdapterT::bucketCount(c);
+        moves.start();
+        yoshi::PerfCounters::instance().start();
+        const auto start = std::chrono::steady_clock::now();
+        AdapterT::insert(c, growth, value);
+        const auto end = std::chrono::steady_clock::now();
+        yoshi::PerfCounters::instance().stop();
+        moves.stop();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+        if (AdapterT::bucketCount(c) == buckets)
+        {
+            throw std::runtime_error("excepted the insert of " + std::to_string(growth) + " to grow the map");
+        }
     }
+    moves.report(state, state.iterations() * growth);
+    yoshi::PerfCounters::instance().setOperations(growth);
 }
 
 template <typename K, typename V, template<typename ...> typename H>
 void Rehash(benchmark::State& state)
 {
     using SupportUnconditionnalRehash = typename Traits<K, V, H>::SupportUnconditionnalRehash;
-    Rehash_Impl<K,V,H>(state, std::false_type{});
+    Rehash_Impl<K,V,H>(state, SupportUnconditionnalRehash{});
 }
 
-#define DECLARE_ALL_TESTS(C) \
-    YOSHI_ADD_BENCHMARK(Insert_Sequential, int64_t, int64_t, C) \
-    YOSHI_ADD_BENCHMARK(Insert_Sequential, int32_t, int32_t, C) \
-    YOSHI_ADD_BENCHMARK(Insert_Random, int64_t, int64_t, C)     \
-    YOSHI_ADD_BENCHMARK(Insert_Random, int64_t, std::string, C) \
-    YOSHI_ADD_BENCHMARK(Erase_Sequential, int64_t, int64_t, C)  \
-    YOSHI_ADD_BENCHMARK(Erase_Random, int64_t, int64_t, C)      \
-    YOSHI_ADD_BENCHMARK(Find_Sequential, int64_t, int64_t, C)   \
-    YOSHI_ADD_BENCHMARK(Find_Random, int64_t, int64_t, C)       \
-    YOSHI_ADD_SHORT_BENCHMARK(Insert_Erase_Random, int64_t, C)  \
-    YOSHI_ADD_BENCHMARK(Find_HalfHit, int64_t, int64_t, C)      \
-    YOSHI_ADD_BENCHMARK(Find_Miss, int64_t, int64_t, C)         \
-    YOSHI_ADD_SHORT_BENCHMARK(Rehash, int64_t, int64_t, C)
+/// Applies the arguments of the batched lookups: for each size the batch sizes
+inline void batchArgs(benchmark::internal::Benchmark* b, const std::vector<int64_t>& sizes)
+{
+    for (auto size : sizes)
+    {
+        for (int64_t batch : {16, 32, 64})
+        {
+            b->Args({size, batch});
+        }
+    }
+}
+
+/// Returns `count` tokens of Adapter::prefetch with Prefetch, else no token
+template <typename AdapterT, bool Prefetch>
+auto prefetchTokens(std::size_t count)
+{
+    if constexpr (Prefetch)
+    {
+        using Token = decltype(AdapterT::prefetch(std::declval<const typename AdapterT::C&>(),
+                                                  std::declval<const typename AdapterT::Key&>()));
+        return std::vector<Token>(count);
+    }
+    else
+    {
+        return std::vector<NoPrehash>();
+    }
+}
+
+/// Inserts [0, state.range(0) -1] in random order and measure the time to find
+/// all of them in a random order, by batches of state.range(1) keys.
+///
+/// With Prefetch the lookups of a batch are pipelined: the memory of all the keys
+/// is prefetched first (see Adapter::prefetch) and then the keys are looked up
+/// with the tokens of the prefetch, else the keys are looked up one after the
+/// other. Prefetch needs a map which CanPrefetch.
+template <typename K, typename V, template<typename ...> typename H, bool Prefetch>
+void Find_Batch_Impl(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        Type c;
+        std::vector<K> keys;
+        int64_t found = 0;
+    };
+    auto value = ValueSelector<V>::value();
+    const int64_t batch = state.range(1);
+    auto tokens = prefetchTokens<AdapterT, Prefetch>(batch);
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
+        {
+            shuffledKeys(instance.keys, state.range(0), generator);
+            AdapterT::clear(instance.c);
+            AdapterT::reserve(instance.c, state.range(0));
+            for (auto key : instance.keys)
+            {
+                AdapterT::insert(instance.c, key, value);
+            }
+            std::shuffle(instance.keys.begin(), instance.keys.end(), generator);
+            instance.found = 0;
+        },
+        [&](Instance& instance)
+        {
+            const auto& keys = instance.keys;
+            for (int64_t begin = 0; begin < state.range(0); begin += batch)
+            {
+                const auto end = std::min<int64_t>(begin + batch, state.range(0));
+                if constexpr (Prefetch)
+                {
+                    for (auto i = begin; i < end; ++i)
+                    {
+                        tokens[i - begin] = AdapterT::prefetch(instance.c, keys[i]);
+                    }
+                    for (auto i = begin; i < end; ++i)
+                    {
+                        auto it = AdapterT::findPrefetched(instance.c, tokens[i - begin], keys[i]);
+                        instance.found += (it != AdapterT::end(instance.c));
+                    }
+                }
+                else
+                {
+                    for (auto i = begin; i < end; ++i)
+                    {
+                        auto it = AdapterT::find(instance.c, keys[i]);
+                        instance.found += (it != AdapterT::end(instance.c));
+                    }
+                }
+            }
+        },
+        [&](Instance& instance) { checkFound(state.range(0), instance.found); });
+}
+
+template <typename K, typename V, template<typename ...> typename H>
+void Find_Batch_Naive(benchmark::State& state)
+{
+    Find_Batch_Impl<K, V, H, false>(state);
+}
+
+template <typename K, typename V, template<typename ...> typename H>
+void Find_Batch_Prefetch(benchmark::State& state)
+{
+    Find_Batch_Impl<K, V, H, true>(state);
+}
+
+/// Inserts state.range(0) string keys in random order, their lengths following
+/// the distribution Length (see generateStringKeys)
+template <typename K, typename V, template<typename ...> typename H, typename Length>
+void Insert_String(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    const auto value = ValueSelector<V>::value();
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    const auto keys = generateStringKeys<Length>(state.range(0), generator);
+    yoshi::runBatched<Type>(state, state.range(0),
+        [&](Type& c)
+        {
+            AdapterT::clear(c);
+            AdapterT::reserve(c, state.range(0));
+        },
+        [&](Type& c, auto recording)
+        {
+            for (const auto& key : keys)
+            {
+                yoshi::latency::record(recording, [&] { return AdapterT::insert(c, key, value); });
+            }
+        },
+        [](Type&) {});
+}
+
+/// Inserts state.range(0) string keys and measure the time to find all of them
+/// in a random order.
+///
+/// With View the keys are looked up from std::string_view: the hashmaps with
+/// heterogeneous lookups use it as is, the others need a temporary std::string.
+/// The allocations done by the lookups are reported as allocations_per_find.
+template <typename K, typename V, template<typename ...> typename H, typename Length, bool View>
+void Find_String_Impl(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        Type c;
+        bool built = false;
+        int64_t found = 0;
+    };
+    const auto value = ValueSelector<V>::value();
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    const auto keys = generateStringKeys<Length>(state.range(0), generator);
+    // separate copies of the keys, the lookups do not hit the memory of the map
+    auto lookups = keys;
+    std::shuffle(lookups.begin(), lookups.end(), generator);
+    std::vector<std::string_view> views(lookups.begin(), lookups.end());
+
+    auto findAll = [&](Type& c, auto recording)
+    {
+        int64_t found = 0;
+        if constexpr (View)
+        {
+            for (const auto& key : views)
+            {
+                auto it = yoshi::latency::record(recording, [&] { return AdapterT::findHeterogeneous(c, key); });
+                found += (it != AdapterT::end(c));
+            }
+        }
+        else
+        {
+            for (const auto& key : lookups)
+            {
+                auto it = yoshi::latency::record(recording, [&] { return AdapterT::find(c, key); });
+                found += (it != AdapterT::end(c));
+            }
+        }
+        return found;
+    };
+
+    int64_t allocations = 0;
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
+        {
+            // the lookups do not modify the map, it is only built once
+            if (not instance.built)
+            {
+                instance.built = true;
+                for (const auto& key : keys)
+                {
+                    AdapterT::insert(instance.c, key, value);
+                }
+                yoshi::memory::Scope scope;
+                findAll(instance.c, std::false_type());
+                allocations = yoshi::memory::stats().allocations;
+            }
+            instance.found = 0;
+        },
+        [&](Instance& instance, auto recording) { instance.found = findAll(instance.c, recording); },
+        [&](Instance& instance) { checkFound(state.range(0), instance.found); });
+    if constexpr (TracksMemory<Type>::value)
+    {
+        state.counters["allocations_per_find"] = static_cast<double>(allocations) / state.range(0);
+    }
+}
+
+template <typename K, typename V, template<typename ...> typename H, typename Length>
+void Find_String(benchmark::State& state)
+{
+    Find_String_Impl<K, V, H, Length, false>(state);
+}
+
+template <typename K, typename V, template<typename ...> typename H, typename Length>
+void Find_String_View(benchmark::State& state)
+{
+    Find_String_Impl<K, V, H, Length, true>(state);
+}
+
+/// Inserts state.range(0) string keys and measure the time to erase all of them
+/// in a random order
+template <typename K, typename V, template<typename ...> typename H, typename Length>
+void Erase_String(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        Type c;
+        std::vector<K> erased;
+    };
+    const auto value = ValueSelector<V>::value();
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    const auto keys = generateStringKeys<Length>(state.range(0), generator);
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
+        {
+            AdapterT::clear(instance.c);
+            AdapterT::reserve(instance.c, state.range(0));
+            for (const auto& key : keys)
+            {
+                AdapterT::insert(instance.c, key, value);
+            }
+            instance.erased = keys;
+            std::shuffle(instance.erased.begin(), instance.erased.end(), generator);
+        },
+        [&](Instance& instance, auto recording)
+        {
+            for (const auto& key : instance.erased)
+            {
+                yoshi::latency::record(recording, [&] { return AdapterT::erase(instance.c, key); });
+            }
+        },
+        [](Instance&) {});
+}
+
+/// Values of the replayed orders, built from their payload size: the size itself
+/// for the integers, a string of that size for the strings
+template <typename V>
+struct Payloads
+{
+    explicit Payloads(std::uint32_t) {}
+    V operator()(std::uint32_t payload) const { return static_cast<V>(payload); }
+};
+
+template <>
+struct Payloads<std::string>
+{
+    explicit Payloads(std::uint32_t maxPayload)
+    {
+        for (std::uint32_t size = 0; size <= maxPayload; ++size)
+        {
+            m_values.emplace_back(size, 'x');
+        }
+    }
+
+    const std::string& operator()(std::uint32_t payload) const { return m_values[payload]; }
+
+private:
+    std::vector<std::string> m_values;
+};
+
+/// Applies the arguments of the trace replay: the number of events of the trace
+/// file if one is given, else the sizes of the synthetic traces
+inline void traceArgs(benchmark::internal::Benchmark* b, const std::vector<int64_t>& sizes)
+{
+    if (not yoshi::options().trace.empty())
+    {
+        b->Arg(yoshi::trace::get(0).size());
+        return;
+    }
+    for (auto size : sizes)
+    {
+        b->Arg(size);
+    }
+}
+
+/// Replays the state.range(0) events of an order book trace (see yoshi/trace.hpp)
+/// on an empty hashmap keyed by the order ids: the orders are inserted, their
+/// value updated and then erased. The trace is the one given with --trace, else
+/// a synthetic one.
+template <typename K, typename V, template<typename ...> typename H>
+void Replay_Trace(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    using yoshi::trace::Op;
+    struct Instance
+    {
+        Type c;
+        int64_t misses = 0;
+    };
+    const auto& trace = yoshi::trace::get(state.range(0));
+    const Payloads<V> payloads(trace.maxPayload());
+    int64_t misses = 0;
+    yoshi::runBatched<Instance>(state, trace.size(),
+        [&](Instance& instance)
+        {
+            AdapterT::clear(instance.c);
+            instance.misses = 0;
+        },
+        [&](Instance& instance, auto recording)
+        {
+            auto& c = instance.c;
+            for (const auto& event : trace)
+            {
+                const K key = event.key;
+                switch (event.op)
+                {
+                case Op::ADD:
+                    yoshi::latency::record(recording, [&] { return AdapterT::insert(c, key, payloads(event.payload)); });
+                    break;
+                case Op::MODIFY:
+                    instance.misses += not yoshi::latency::record(recording, [&] { return AdapterT::update(c, key, payloads(event.payload)); });
+                    break;
+                case Op::CANCEL:
+                    instance.misses += not yoshi::latency::record(recording, [&] { return AdapterT::erase(c, key); });
+                    break;
+                }
+            }
+        },
+        [&](Instance& instance) { misses = instance.misses; });
+    state.SetItemsProcessed(state.iterations() * trace.size());
+    // the events on orders unknown to the trace, expected when it starts during the day
+    state.counters["misses"] = misses;
+}
+
+/// Returns the bytes allocated and not freed since the yoshi::memory::Scope
+/// started: by the operator new when it tracks the maps C, else by malloc
+template <typename C>
+std::int64_t liveBytes()
+{
+    if constexpr (TracksMemory<C>::value)
+    {
+        return yoshi::memory::stats().live;
+    }
+    else
+    {
+        return yoshi::memory::heapLive();
+    }
+}
+
+/// Inserts [0, state.range(0) -1] in random order without reserving and
+/// measures the memory allocated by the map. All the allocations are tracked
+/// during the timed region so the timing is only indicative. The peak RSS is
+/// the one of an untimed map built alone, when the peak can be reset.
+template <typename K, typename V, template<typename ...> typename H>
+void Memory_Footprint(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        // built in the tracked region, without the memory of the previous batch
+        std::optional<Type> c;
+        std::vector<K> keys;
+    };
+    const auto value = ValueSelector<V>::value();
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    yoshi::memory::Stats stats;
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
+        {
+            instance.c.reset();
+            shuffledKeys(instance.keys, state.range(0), generator);
+        },
+        [&](Instance& instance)
+        {
+            yoshi::memory::Scope scope;
+            auto& c = instance.c.emplace();
+            for (auto key : instance.keys)
+            {
+                AdapterT::insert(c, key, value);
+            }
+            stats = yoshi::memory::stats();
+            stats.live = liveBytes<Type>();
+        },
+        [](Instance&) {});
+    const double entries = state.range(0);
+    state.counters["bytes_per_entry"] = stats.live / entries;
+    if constexpr (TracksMemory<Type>::value)
+    {
+        state.counters["allocations_per_entry"] = stats.allocations / entries;
+        state.counters["peak_bytes"] = stats.peak;
+    }
+    // the resident memory of a map built alone, from the resident memory
+    // without the maps of the batches
+    std::vector<K> keys;
+    shuffledKeys(keys, state.range(0), generator);
+    if (yoshi::memory::resetPeakRss())
+    {
+        const auto before = yoshi::memory::rss();
+        Type c;
+        for (auto key : keys)
+        {
+            AdapterT::insert(c, key, value);
+        }
+        state.counters["peak_rss"] = yoshi::memory::peakRss() - before;
+    }
+}
+
+/// Inserts [0, state.range(0) -1] in random order, erases ErasedPercent % of
+/// them in another random order and measure the time to iterate over the map,
+/// reading the keys or the values. The time is per key inserted: after the
+/// erasures the scan still goes through the table sized for all of them.
+///
+/// Reports the footprint of the map, its bytes allocated: a bound of the memory
+/// a scan reads, not the bytes actually read.
+template <typename K, typename V, template<typename ...> typename H, int ErasedPercent, bool Values>
+void Scan_Impl(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        Type c;
+        bool built = false;
+        int64_t sum = 0;
+    };
+    const auto value = ValueSelector<V>::value();
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    std::vector<K> keys;
+    shuffledKeys(keys, state.range(0), generator);
+    const auto erased = static_cast<std::size_t>(state.range(0) * ErasedPercent / 100);
+    int64_t expected = 0;
+    for (auto it = keys.begin() + erased; it != keys.end(); ++it)
+    {
+        expected += Values ? value : *it;
+    }
+    int64_t bytes = 0;
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
+        {
+            // the scans do not modify the map, it is only built once
+            if (not instance.built)
+            {
+                instance.built = true;
+                yoshi::memory::Scope scope;
+                for (auto key : keys)
+                {
+                    AdapterT::insert(instance.c, key, value);
+                }
+                for (std::size_t i = 0; i < erased; ++i)
+                {
+                    AdapterT::erase(instance.c, keys[i]);
+                }
+                bytes = liveBytes<Type>();
+            }
+            instance.sum = 0;
+        },
+        [&](Instance& instance)
+        {
+            int64_t sum = 0;
+            for (auto it = AdapterT::begin(instance.c); it != AdapterT::end(instance.c); ++it)
+            {
+                if constexpr (Values)
+                {
+                    sum += mappedValue(it);
+                }
+                else
+                {
+                    sum += mappedKey(it);
+                }
+            }
+            instance.sum = sum;
+        },
+        [&](Instance& instance) { checkFound(expected, instance.sum); });
+    state.counters["footprint"] = bytes;
+    state.counters["bytes_per_element"] = static_cast<double>(bytes) / std::max<std::size_t>(keys.size() - erased, 1);
+}
+
+/// Iterates over a full map reading the keys
+template <typename K, typename V, template<typename ...> typename H>
+void Iterate_Full(benchmark::State& state)
+{
+    Scan_Impl<K, V, H, 0, false>(state);
+}
+
+/// Iterates over a map where 90 % of the keys were erased, reading the keys:
+/// the tombstones and empty slots of the flat maps are still scanned
+template <typename K, typename V, template<typename ...> typename H>
+void Iterate_AfterErase(benchmark::State& state)
+{
+    Scan_Impl<K, V, H, 90, false>(state);
+}
+
+/// Iterates over a full map summing the values, the keys are not read
+template <typename K, typename V, template<typename ...> typename H>
+void Sum_Values(benchmark::State& state)
+{
+    Scan_Impl<K, V, H, 0, true>(state);
+}
+
+/// Times each operation on a map, the first `prefill` keys being inserted
+/// untimed, then:
+/// - without Churn, inserts the other keys
+/// - with Churn, erases the oldest key and inserts the next one, the size of
+///   the map staying the same
+/// Reports the stalls and the memory of the operations, see Growth_Timeline
+template <typename K, typename V, template<typename ...> typename H, bool Churn>
+void Timeline_Impl(benchmark::State& state, std::int64_t prefill, std::int64_t operations)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+
+    const auto value = ValueSelector<V>::value();
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    std::vector<K> keys;
+    std::vector<yoshi::timeline::Point> points(operations);
+    yoshi::memory::Stats stats;
+    MoveCounter<V> moves;
+    for (auto _ : state)
+    {
+        shuffledKeys(keys, prefill + operations, generator);
+        std::uint64_t total = 0;
+        {
+            std::optional<Type> c;
+            yoshi::memory::Scope scope;
+            c.emplace();
+            for (std::int64_t i = 0; i < prefill; ++i)
+            {
+                AdapterT::insert(*c, keys[i], value);
+            }
+            moves.start();
+            yoshi::PerfCounters::instance().start();
+            for (std::int64_t i = 0; i < operations; ++i)
+            {
+                const auto begin = yoshi::latency::start();
+                if constexpr (Churn)
+                {
+                    AdapterT::erase(*c, keys[i]);
+                }
+                AdapterT::insert(*c, keys[prefill + i], value);
+                points[i].ticks = yoshi::latency::stop() - begin;
+                points[i].live = liveBytes<Type>();
+                total += points[i].ticks;
+            }
+            yoshi::PerfCounters::instance().stop();
+            moves.stop();
+            stats = yoshi::memory::stats();
+            if constexpr (not TracksMemory<Type>::value)
+            {
+                // malloc gives no peak, it is the highest of the operations
+                stats.live = liveBytes<Type>();
+                stats.peak = std::max_element(points.begin(), points.end(),
+                                              [](const auto& a, const auto& b) { return a.live < b.live; })->live;
+            }
+        }
+        state.SetIterationTime(total / yoshi::latency::ticksPerNanosecond() / 1e9);
+    }
+    std::vector<std::uint64_t> ticks(points.size());
+    std::transform(points.begin(), points.end(), ticks.begin(), [](const auto& p) { return p.ticks; });
+    std::nth_element(ticks.begin(), ticks.begin() + ticks.size() / 2, ticks.end());
+    const auto median = ticks[ticks.size() / 2];
+    const auto max = *std::max_element(ticks.begin(), ticks.end());
+    state.counters["stall_ns"] = max / yoshi::latency::ticksPerNanosecond();
+    state.counters["stalls"] = std::count_if(points.begin(), points.end(),
+                                             [median](const auto& p) { return p.ticks > 100 * median; });
+    state.counters["peak_bytes"] = stats.peak;
+    state.counters["final_bytes"] = stats.live;
+    state.counters["peak_ratio"] = static_cast<double>(stats.peak) / std::max<std::int64_t>(stats.live, 1);
+    moves.report(state, state.iterations() * operations);
+    yoshi::PerfCounters::instance().setOperations(operations);
+    if (not yoshi::options().timeline.empty())
+    {
+        yoshi::timeline::write(state.range(0), points);
+    }
+}
+
+/// Inserts [0, state.range(0) -1] in random order without reserving and times
+/// each insert, to see the stalls of the growths of the map and the memory
+/// allocated meanwhile, the previous and the new table being both alive.
+///
+/// Reports the slowest insert, the number of stalls (inserts 100 times slower
+/// than the median one), the peak of allocated bytes and its ratio to the final
+/// size of the map. With the timeline option the latency and allocated bytes
+/// after each insert of the last iteration are written (see yoshi/timeline.hpp).
+template <typename K, typename V, template<typename ...> typename H>
+void Growth_Timeline(benchmark::State& state)
+{
+    Timeline_Impl<K, V, H, false>(state, 0, state.range(0));
+}
+
+/// Fills a map with state.range(0) keys, then erases the oldest key and inserts
+/// a new one 2 * state.range(0) times, timing each pair. The size stays the
+/// same but the erased slots of the flat maps become tombstones, which a table
+/// drops by rehashing when they fill it: the stalls are these rehashes.
+template <typename K, typename V, template<typename ...> typename H>
+void Churn_Timeline(benchmark::State& state)
+{
+    Timeline_Impl<K, V, H, true>(state, state.range(0), 2 * state.range(0));
+}
+
+/// Call shapes of Upsert, each one writing a key with the Adapter method of
+/// the same name
+struct ByInsert
+{
+    template <typename AdapterT, typename K, typename V>
+    static auto write(typename AdapterT::C& c, const K& k, const V& v) { return AdapterT::insert(c, k, v); }
+};
+
+struct ByEmplace
+{
+    template <typename AdapterT, typename K, typename V>
+    static auto write(typename AdapterT::C& c, const K& k, const V& v) { return AdapterT::emplace(c, k, v); }
+};
+
+struct ByTryEmplace
+{
+    template <typename AdapterT, typename K, typename V>
+    static auto write(typename AdapterT::C& c, const K& k, const V& v) { return AdapterT::tryEmplace(c, k, v); }
+};
+
+struct ByInsertOrAssign
+{
+    template <typename AdapterT, typename K, typename V>
+    static auto write(typename AdapterT::C& c, const K& k, const V& v) { return AdapterT::insertOrAssign(c, k, v); }
+};
+
+struct BySubscript
+{
+    template <typename AdapterT, typename K, typename V>
+    static auto write(typename AdapterT::C& c, const K& k, const V& v) { return AdapterT::upsert(c, k, v); }
+};
+
+struct ByExtract
+{
+    template <typename AdapterT, typename K, typename V>
+    static auto write(typename AdapterT::C& c, const K& k, const V& v) { return AdapterT::reinsert(c, k, v); }
+};
+
+/// Inserts [0, state.range(0) -1] and measure the time to write the keys
+/// [0, 1.1 * state.range(0) -1] in random order through the call shape Path:
+/// 10 existing keys for 1 new one, like the update heavy workloads. Insert,
+/// emplace and try_emplace leave the existing values unchanged, the other
+/// paths assign them.
+///
+/// Reports the allocations and the copies and moves of the Tracked values per
+/// call, counted on a first untimed run: emplace may build a node before
+/// finding the key, insert builds a std::pair, extract reuses the node.
+template <typename K, typename V, template<typename ...> typename H, typename Path>
+void Upsert(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        Type c;
+        std::vector<K> keys;
+    };
+    // not the const char* of the std::string selector, converted by each call
+    const V value = ValueSelector<V>::value();
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    const int64_t calls = state.range(0) + state.range(0) / 10;
+
+    auto fill = [&](Instance& instance)
+    {
+        shuffledKeys(instance.keys, calls, generator);
+        AdapterT::clear(instance.c);
+        AdapterT::reserve(instance.c, calls);
+        for (K i = 0; i < state.range(0); ++i)
+        {
+            AdapterT::insert(instance.c, i, value);
+        }
+    };
+    auto writeAll = [&](Instance& instance, auto recording)
+    {
+        for (auto key : instance.keys)
+        {
+            yoshi::latency::record(recording, [&] { return Path::template write<AdapterT>(instance.c, key, value); });
+        }
+    };
+
+    yoshi::memory::Stats stats;
+    MoveCounter<V> moves;
+    {
+        Instance instance;
+        fill(instance);
+        yoshi::memory::Scope scope;
+        moves.start();
+        writeAll(instance, std::false_type());
+        moves.stop();
+        stats = yoshi::memory::stats();
+    }
+    yoshi::runBatched<Instance>(state, calls, fill, writeAll,
+        [&](Instance& instance)
+        {
+            int64_t found = 0;
+            for (K i = 0; i < calls; ++i)
+            {
+                found += (AdapterT::find(instance.c, i) != AdapterT::end(instance.c));
+            }
+            checkFound(calls, found);
+        });
+    if constexpr (TracksMemory<Type>::value)
+    {
+        state.counters["allocations_per_call"] = static_cast<double>(stats.allocations) / calls;
+    }
+    moves.report(state, calls);
+}
+
+/// Returns the path of the temporary file yoshi_<pid>_<name>, in /dev/shm when
+/// `inMemory` and it exists so the file is in memory like the in-heap maps,
+/// else in the temporary directory
+inline std::string temporaryPath(const std::string& name, bool inMemory)
+{
+    const std::filesystem::path directory = inMemory and std::filesystem::is_directory("/dev/shm")
+        ? std::filesystem::path("/dev/shm") : std::filesystem::temp_directory_path();
+    return (directory / ("yoshi_" + std::to_string(::getpid()) + "_" + name)).string();
+}
+
+/// Path of a temporary file, removed with it whatever the way out of the
+/// benchmark
+struct TemporaryFile
+{
+    const std::string path;
+
+    explicit TemporaryFile(std::string p) : path(std::move(p)) {}
+    TemporaryFile(const TemporaryFile&) = delete;
+    ~TemporaryFile() { std::remove(path.c_str()); }
+};
+
+/// Snapshot kept in a buffer, which is in memory during the whole load
+struct InMemory
+{
+    std::vector<char> buffer;
+
+    yoshi::snapshot::BufferWriter writer() { return yoshi::snapshot::BufferWriter(buffer); }
+    yoshi::snapshot::BufferReader reader() const { return yoshi::snapshot::BufferReader(buffer); }
+    std::size_t bytes() const { return buffer.size(); }
+    /// Bytes of the snapshot in memory before the load
+    std::size_t resident() const { return buffer.size(); }
+};
+
+/// Snapshot streamed by chunks to a file of the temporary directory (on disk,
+/// not in /dev/shm), never in memory as a whole
+struct Streamed
+{
+    const std::string path = temporaryPath("snapshot", false);
+
+    Streamed() = default;
+    Streamed(const Streamed&) = delete;
+    ~Streamed() { std::remove(path.c_str()); }
+
+    yoshi::snapshot::FileWriter writer() const { return yoshi::snapshot::FileWriter(path); }
+    yoshi::snapshot::FileReader reader() const { return yoshi::snapshot::FileReader(path); }
+    std::size_t bytes() const { return std::filesystem::file_size(path); }
+    std::size_t resident() const { return 0; }
+};
+
+/// Writes the elements of `c` as records
+template <typename AdapterT, typename Writer>
+void saveRecords(typename AdapterT::C& c, Writer& writer)
+{
+    yoshi::snapshot::writeRecords<typename AdapterT::Key, typename AdapterT::Value>(
+        writer, AdapterT::size(c), AdapterT::begin(c), AdapterT::end(c),
+        [](const auto& it) -> decltype(auto) { return mappedKey(it); },
+        [](const auto& it) -> decltype(auto) { return mappedValue(it); });
+}
+
+/// Loads the records by inserting them one by one without reserving, the way
+/// Insert_Random builds a map
+struct ByReinsert
+{
+    template <typename AdapterT, typename Writer>
+    static void save(typename AdapterT::C& c, Writer& writer) { saveRecords<AdapterT>(c, writer); }
+
+    template <typename AdapterT, typename Reader>
+    static auto load(Reader& reader)
+    {
+        using K = typename AdapterT::Key;
+        using V = typename AdapterT::Value;
+        typename AdapterT::C c;
+        const auto header = yoshi::snapshot::readHeader<K, V>(reader);
+        yoshi::snapshot::readRecords<K, V>(reader, header, [&](const K& k, const V& v) { AdapterT::insert(c, k, v); });
+        return c;
+    }
+};
+
+/// Loads the records after reserving the size of the snapshot: no growth
+struct ByPresized
+{
+    template <typename AdapterT, typename Writer>
+    static void save(typename AdapterT::C& c, Writer& writer) { saveRecords<AdapterT>(c, writer); }
+
+    template <typename AdapterT, typename Reader>
+    static auto load(Reader& reader)
+    {
+        using K = typename AdapterT::Key;
+        using V = typename AdapterT::Value;
+        typename AdapterT::C c;
+        const auto header = yoshi::snapshot::readHeader<K, V>(reader);
+        AdapterT::reserve(c, header.count);
+        yoshi::snapshot::readRecords<K, V>(reader, header, [&](const K& k, const V& v) { AdapterT::insert(c, k, v); });
+        return c;
+    }
+};
+
+/// Saves and loads the image of the table, copied as is, only for the hashmaps
+/// without pointers (see HasImage)
+struct ByImage
+{
+    template <typename AdapterT, typename Writer>
+    static void save(typename AdapterT::C& c, Writer& writer)
+    {
+        static_assert(HasImage<typename AdapterT::C>::value, "ByImage needs a hashmap with an image");
+        yoshi::snapshot::writeImage<typename AdapterT::Key, typename AdapterT::Value>(
+            writer, c.size(), c.image(), c.bytes());
+    }
+
+    template <typename AdapterT, typename Reader>
+    static auto load(Reader& reader)
+    {
+        using C = typename AdapterT::C;
+        static_assert(HasImage<C>::value, "ByImage needs a hashmap with an image");
+        const auto header = yoshi::snapshot::readHeader<typename AdapterT::Key, typename AdapterT::Value>(reader);
+        if (header.format != yoshi::snapshot::IMAGE)
+        {
+            throw std::runtime_error("excepted the snapshot of a table image");
+        }
+        return C::fromImage(header.bytes, [&](char* data, std::size_t bytes) { reader.read(data, bytes); });
+    }
+};
+
+/// Fills `c` with [0, count -1] in a random order
+template <typename AdapterT>
+void fillRandom(typename AdapterT::C& c, int64_t count)
+{
+    using K = typename AdapterT::Key;
+    const auto value = ValueSelector<typename AdapterT::Value>::value();
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    std::vector<K> keys;
+    shuffledKeys(keys, count, generator);
+    for (auto key : keys)
+    {
+        AdapterT::insert(c, key, value);
+    }
+}
+
+/// Measures the time to write a map of state.range(0) elements to a snapshot
+/// (see yoshi/hashmap/snapshot.hpp) in the Storage (InMemory or Streamed), as
+/// records or as the image of the table with ByImage
+template <typename K, typename V, template<typename ...> typename H, typename Storage, typename Build>
+void Snapshot_Save(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    Type c;
+    fillRandom<AdapterT>(c, state.range(0));
+    Storage storage;
+    for (auto _ : state)
+    {
+        yoshi::PerfCounters::instance().start();
+        const auto start = std::chrono::steady_clock::now();
+        auto writer = storage.writer();
+        Build::template save<AdapterT>(c, writer);
+        writer.flush();
+        const auto end = std::chrono::steady_clock::now();
+        yoshi::PerfCounters::instance().stop();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+    }
+    state.SetBytesProcessed(state.iterations() * storage.bytes());
+    state.counters["snapshot_bytes"] = storage.bytes();
+}
+
+/// Measures the time to restore a map of state.range(0) elements from its
+/// snapshot in the Storage, the way given by Build (ByReinsert, ByPresized or
+/// ByImage). Reports the bytes of the map once loaded and the peak of memory
+/// during the load, snapshot included.
+template <typename K, typename V, template<typename ...> typename H, typename Storage, typename Build>
+void Snapshot_Load(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    Storage storage;
+    {
+        Type c;
+        fillRandom<AdapterT>(c, state.range(0));
+        auto writer = storage.writer();
+        Build::template save<AdapterT>(c, writer);
+        writer.flush();
+    }
+    auto load = [&]
+    {
+        auto reader = storage.reader();
+        return Build::template load<AdapterT>(reader);
+    };
+    auto check = [&](Type& c)
+    {
+        checkFound(state.range(0), AdapterT::size(c));
+        checkFound(1, AdapterT::find(c, state.range(0) / 2) != AdapterT::end(c));
+    };
+
+    yoshi::memory::Stats stats;
+    {
+        yoshi::memory::Scope scope;
+        auto c = load();
+        stats = yoshi::memory::stats();
+        stats.live = liveBytes<Type>();
+        check(c);
+    }
+    for (auto _ : state)
+    {
+        yoshi::PerfCounters::instance().start();
+        const auto start = std::chrono::steady_clock::now();
+        auto c = load();
+        const auto end = std::chrono::steady_clock::now();
+        yoshi::PerfCounters::instance().stop();
+        state.SetIterationTime(std::chrono::duration<double>(end - start).count());
+        check(c);
+    }
+    state.SetBytesProcessed(state.iterations() * storage.bytes());
+    state.counters["bytes_per_entry"] = static_cast<double>(stats.live) / state.range(0);
+    if constexpr (TracksMemory<Type>::value)
+    {
+        state.counters["peak_bytes"] = stats.peak + storage.resident();
+    }
+}
+
+/// Entries of all the maps measured by a lifecycle benchmark: moving, clearing
+/// or destroying a map is much cheaper than building it, so the number of maps
+/// is chosen from their size to build about the same number of entries, and not
+/// by google benchmark which would build millions of them to reach its minimum
+/// time (see lifecycleArgs)
+constexpr std::int64_t LIFECYCLE_ENTRIES = std::int64_t(1) << 24;
+constexpr std::int64_t LIFECYCLE_MIN_MAPS = 16;
+
+/// Applies the sizes of the lifecycle benchmarks, pinned to one iteration of
+/// google benchmark running all their maps
+inline void lifecycleArgs(benchmark::internal::Benchmark* b, const std::vector<int64_t>& sizes)
+{
+    for (auto size : sizes)
+    {
+        b->Arg(size);
+    }
+    b->Iterations(1);
+}
+
+/// Times `run(instance)` on the instances prepared by `setup(instance)`, each
+/// one doing the operation on a map of state.range(0) elements, and reports the
+/// memory the operation allocates and frees in the maps C, measured on an
+/// untimed run (only its balance for the maps allocating with malloc)
+template <typename C, typename Instance, typename Setup, typename Run>
+void runLifecycle(benchmark::State& state, Setup&& setup, Run&& run)
+{
+    yoshi::memory::Stats stats;
+    {
+        Instance instance;
+        setup(instance);
+        yoshi::memory::Scope scope;
+        run(instance);
+        stats = yoshi::memory::stats();
+        stats.live = liveBytes<C>();
+    }
+    const auto maps = std::max(LIFECYCLE_ENTRIES / state.range(0), LIFECYCLE_MIN_MAPS);
+    yoshi::runInstances<Instance>(state, maps, state.range(0), setup, run, [](Instance&) {});
+    if constexpr (TracksMemory<C>::value)
+    {
+        const double entries = state.range(0);
+        state.counters["bytes_allocated"] = stats.allocated;
+        state.counters["bytes_freed"] = stats.allocated - stats.live;
+        state.counters["allocations_per_entry"] = stats.allocations / entries;
+        state.counters["deallocations_per_entry"] = stats.deallocations / entries;
+    }
+    else
+    {
+        // malloc only gives the balance of the operation
+        state.counters["bytes_allocated"] = std::max<std::int64_t>(stats.live, 0);
+        state.counters["bytes_freed"] = std::max<std::int64_t>(-stats.live, 0);
+    }
+}
+
+/// Keys and value of the lifecycle benchmarks: the maps are built by inserting
+/// [0, state.range(0) -1] in random order, as a copy would lay their nodes out
+/// in order (and QHash would share the data of the copy)
+template <typename AdapterT>
+struct LifecycleData
+{
+    using K = typename AdapterT::Key;
+    using V = typename AdapterT::Value;
+
+    explicit LifecycleData(int64_t count)
+        : value(ValueSelector<V>::value())
+    {
+        const std::int64_t SEED = 0;
+        std::mt19937_64 generator(SEED);
+        shuffledKeys(keys, count, generator);
+    }
+
+    void fill(typename AdapterT::C& c) const
+    {
+        for (auto key : keys)
+        {
+            AdapterT::insert(c, key, value);
+        }
+    }
+
+    std::vector<K> keys;
+    const V value;
+};
+
+/// Copy constructs a map of state.range(0) elements
+template <typename K, typename V, template<typename ...> typename H>
+void Copy(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        std::optional<Type> c;
+    };
+    const LifecycleData<AdapterT> data(state.range(0));
+    Type source;
+    data.fill(source);
+    runLifecycle<Type, Instance>(state,
+        [&](Instance& instance) { instance.c.reset(); },
+        [&](Instance& instance) { instance.c.emplace(source); });
+}
+
+/// Move constructs a map of state.range(0) elements. The map is moved back to
+/// the source out of the timing, so it is only built once.
+template <typename K, typename V, template<typename ...> typename H>
+void Move(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        std::optional<Type> source;
+        std::optional<Type> c;
+    };
+    const LifecycleData<AdapterT> data(state.range(0));
+    runLifecycle<Type, Instance>(state,
+        [&](Instance& instance)
+        {
+            if (instance.c)
+            {
+                instance.source.emplace(std::move(*instance.c));
+                instance.c.reset();
+            }
+            else
+            {
+                data.fill(instance.source.emplace());
+            }
+        },
+        [&](Instance& instance) { instance.c.emplace(std::move(*instance.source)); });
+}
+
+/// Clears a map of state.range(0) elements
+template <typename K, typename V, template<typename ...> typename H>
+void Clear_Full(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        std::optional<Type> c;
+    };
+    const LifecycleData<AdapterT> data(state.range(0));
+    runLifecycle<Type, Instance>(state,
+        [&](Instance& instance) { data.fill(instance.c.emplace()); },
+        [&](Instance& instance) { AdapterT::clear(*instance.c); });
+}
+
+/// Clears a map of state.range(0) elements and inserts them again, without
+/// allocating for the maps keeping their memory on clear. The map is full after
+/// the run, so it is only built once.
+template <typename K, typename V, template<typename ...> typename H>
+void Clear_Reuse(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        std::optional<Type> c;
+    };
+    const LifecycleData<AdapterT> data(state.range(0));
+    runLifecycle<Type, Instance>(state,
+        [&](Instance& instance)
+        {
+            if (not instance.c)
+            {
+                data.fill(instance.c.emplace());
+            }
+        },
+        [&](Instance& instance)
+        {
+            AdapterT::clear(*instance.c);
+            data.fill(*instance.c);
+        });
+}
+
+/// Destroys a map of state.range(0) elements
+template <typename K, typename V, template<typename ...> typename H>
+void Destroy(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        std::optional<Type> c;
+    };
+    const LifecycleData<AdapterT> data(state.range(0));
+    runLifecycle<Type, Instance>(state,
+        [&](Instance& instance) { data.fill(instance.c.emplace()); },
+        [&](Instance& instance) { instance.c.reset(); });
+}
+
+/// Applies the sizes of the startup benchmark, tables of 1M and 10M entries (100k
+/// and 1M in the short mode) whatever the sizes of the run
+inline void startupArgs(benchmark::internal::Benchmark* b, const std::vector<int64_t>&)
+{
+    const auto sizes = yoshi::options().shortRun ? std::vector<int64_t>{100000, 1000000}
+                                                 : std::vector<int64_t>{1000000, 10000000};
+    for (auto size : sizes)
+    {
+        b->Arg(size);
+    }
+}
+
+/// Measures the time from an existing table of state.range(0) entries to the
+/// first lookup in it:
+/// - a file mapped map (see IsFileMapped) is written once and then only opened,
+///   the time is the one of the mapping and of the page faults of the lookup
+/// - an in-heap map is rebuilt from the entries, like after loading a snapshot
+template <typename K, typename V, template<typename ...> typename H>
+void Startup_FirstLookup(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, H>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        std::optional<Type> c;
+        bool found = false;
+    };
+    const auto value = ValueSelector<V>::value();
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    std::vector<K> keys;
+    shuffledKeys(keys, state.range(0), generator);
+    const K first = keys[keys.size() / 2];
+
+    std::optional<TemporaryFile> file;
+    if constexpr (IsFileMapped<Type>::value)
+    {
+        file.emplace(temporaryPath(std::to_string(state.range(0)) + ".map", true));
+        auto c = Type::create(file->path, keys.size());
+        for (auto key : keys)
+        {
+            AdapterT::insert(c, key, value);
+        }
+        state.counters["file_bytes"] = c.bytes();
+    }
+    // batched like the rebuilds, so the instances of the big tables fit in memory
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
+        {
+            instance.c.reset();
+            instance.found = false;
+        },
+        [&](Instance& instance)
+        {
+            if constexpr (IsFileMapped<Type>::value)
+            {
+                instance.c.emplace(Type::open(file->path));
+            }
+            else
+            {
+                auto& c = instance.c.emplace();
+                AdapterT::reserve(c, keys.size());
+                for (auto key : keys)
+                {
+                    AdapterT::insert(c, key, value);
+                }
+            }
+            instance.found = AdapterT::find(*instance.c, first) != AdapterT::end(*instance.c);
+        },
+        [&](Instance& instance) { checkFound(1, instance.found); });
+}
+
+/// Accesses a cache (see cache.hpp) of CachePercent % of a key space of
+/// state.range(0) keys with state.range(0) keys from the distribution, a miss
+/// inserting the key and evicting an entry once the cache is full, like a read
+/// through cache. The cache is warmed with other accesses first, so the time
+/// and the counters are the ones of a full cache:
+/// - hit_rate: the hits per access
+/// - evictions_per_access: the evictions per access
+template <typename K, typename V, template<typename ...> typename H,
+          template<typename, typename, template<typename ...> typename> typename Cache,
+          typename Dist, int CachePercent>
+void Cache_Access(benchmark::State& state)
+{
+    using CacheT = Cache<K, V, H>;
+    struct Instance
+    {
+        std::optional<CacheT> cache;
+        std::vector<K> accesses;
+        int64_t hits = 0;
+        int64_t evictions = 0;
+    };
+    const auto value = ValueSelector<V>::value();
+    const auto capacity = std::max<int64_t>(state.range(0) * CachePercent / 100, 1);
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    Dist distribution(state.range(0), generator);
+    const auto access = [&](Instance& instance)
+    {
+        for (auto key : instance.accesses)
+        {
+            if (auto* v = instance.cache->find(key))
+            {
+                benchmark::DoNotOptimize(*v);
+                ++instance.hits;
+            }
+            else
+            {
+                instance.evictions += instance.cache->insert(key, value);
+            }
+        }
+    };
+    int64_t hits = 0;
+    int64_t evictions = 0;
+    int64_t accesses = 0;
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
+        {
+            instance.cache.emplace(capacity);
+            generateKeys(instance.accesses, distribution, state.range(0), state.range(0), generator);
+            access(instance);
+            generateKeys(instance.accesses, distribution, state.range(0), state.range(0), generator);
+            instance.hits = 0;
+            instance.evictions = 0;
+        },
+        access,
+        [&](Instance& instance)
+        {
+            // the last key accessed is the most recently used one
+            checkFound(1, instance.cache->find(instance.accesses.back()) != nullptr);
+            if (instance.evictions > 0 and instance.cache->size() != static_cast<std::size_t>(capacity))
+            {
+                throw std::logic_error("excepted a full cache after an eviction");
+            }
+            hits += instance.hits;
+            evictions += instance.evictions;
+            accesses += instance.accesses.size();
+        });
+    state.counters["hit_rate"] = static_cast<double>(hits) / accesses;
+    state.counters["evictions_per_access"] = static_cast<double>(evictions) / accesses;
+}
+
+/// Benchmarks of the maps with trivially copyable keys and values, the only ones
+/// a file mapped map (yoshi::MappedMap) can store
+#define DECLARE_TRIVIAL_TESTS(C) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Insert_Sequential, int64_t, int64_t, C)               \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Insert_Sequential, int32_t, int32_t, C)               \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Insert_Random, int64_t, int64_t, C)                   \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Erase_Sequential, int64_t, int64_t, C)                \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Erase_Random, int64_t, int64_t, C)                    \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_Sequential, int64_t, int64_t, C)                 \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_Random, int64_t, int64_t, C)                     \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(insertEraseArgs), Insert_Erase_Random, int64_t, C) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_HalfHit, int64_t, int64_t, C)                    \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_Miss, int64_t, int64_t, C)                       \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Rehash, int64_t, int64_t, C)                    \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(batchArgs), Find_Batch_Naive, int64_t, int64_t, C)       \
+    YOSHI_ADD_BENCHMARK_IF((CanPrefetch<AdaptedMap<int64_t, int64_t, C>, int64_t>::value),             \
+                           yoshi::manualTime(batchArgs), Find_Batch_Prefetch, int64_t, int64_t, C)      \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Memory_Footprint, int64_t, int64_t, C)                \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Growth_Timeline, int64_t, int64_t, C)           \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Churn_Timeline, int64_t, int64_t, C)            \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Iterate_Full, int64_t, int64_t, C)                    \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Iterate_AfterErase, int64_t, int64_t, C)              \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Sum_Values, int64_t, int64_t, C)                      \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(traceArgs), Replay_Trace, int64_t, int64_t, C)           \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(startupArgs), Startup_FirstLookup, int64_t, int64_t, C)  \
+    DECLARE_SKEWED_TESTS(C) \
+    DECLARE_SNAPSHOT_TESTS(C) \
+    DECLARE_LIFECYCLE_TESTS(C, int64_t) \
+    DECLARE_CACHE_TESTS(C)
+
+#define DECLARE_ALL_TESTS(C) \
+    DECLARE_TRIVIAL_TESTS(C) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Insert_Random, int64_t, std::string, C)               \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Memory_Footprint, int64_t, std::string, C)            \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(traceArgs), Replay_Trace, int64_t, std::string, C)       \
+    DECLARE_STRING_TESTS(C) \
+    DECLARE_PAYLOAD_TESTS(C) \
+    DECLARE_UPSERT_TESTS(C) \
+    DECLARE_LIFECYCLE_TESTS(C, std::string)
+
+/// Copy, move, clear and destruction of maps with values of type V
+#define DECLARE_LIFECYCLE_TESTS(C, V) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(lifecycleArgs), Copy, int64_t, V, C)        \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(lifecycleArgs), Move, int64_t, V, C)        \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(lifecycleArgs), Clear_Full, int64_t, V, C)  \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(lifecycleArgs), Clear_Reuse, int64_t, V, C) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(lifecycleArgs), Destroy, int64_t, V, C)
+
+/// Caches accessed uniformly (with replacement, a permutation being a scan for
+/// a cache) and with a Zipf distribution, for each cache built on the map. The
+/// Zipf accesses touch less than half of the key space, so its caches are
+/// smaller to be full.
+#define DECLARE_CACHE_TESTS(C) \
+    DECLARE_CACHE_TESTS_OF(C, yoshi::ListLru) \
+    DECLARE_CACHE_TESTS_OF(C, yoshi::FlatLru) \
+    DECLARE_CACHE_TESTS_OF(C, yoshi::ClockCache)
+
+#define DECLARE_CACHE_TESTS_OF(C, Cache) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Cache_Access, int64_t, int64_t, C, Cache, RandomKeys, 10)   \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Cache_Access, int64_t, int64_t, C, Cache, RandomKeys, 50)   \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Cache_Access, int64_t, int64_t, C, Cache, ZipfKeys<99>, 1)  \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Cache_Access, int64_t, int64_t, C, Cache, ZipfKeys<99>, 10)
+
+/// Snapshots written in memory or streamed to a file, and loaded by reinserting,
+/// after reserving or from the image of the table for the maps having one
+#define DECLARE_SNAPSHOT_TESTS(C) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Snapshot_Save, int64_t, int64_t, C, InMemory, ByPresized) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Snapshot_Save, int64_t, int64_t, C, Streamed, ByPresized) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Snapshot_Load, int64_t, int64_t, C, InMemory, ByReinsert) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Snapshot_Load, int64_t, int64_t, C, InMemory, ByPresized) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Snapshot_Load, int64_t, int64_t, C, Streamed, ByReinsert) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Snapshot_Load, int64_t, int64_t, C, Streamed, ByPresized) \
+    YOSHI_ADD_BENCHMARK_IF((HasImage<AdaptedMap<int64_t, int64_t, C>>::value),                              \
+                           yoshi::manualTime(), Snapshot_Save, int64_t, int64_t, C, InMemory, ByImage)      \
+    YOSHI_ADD_BENCHMARK_IF((HasImage<AdaptedMap<int64_t, int64_t, C>>::value),                              \
+                           yoshi::manualTime(), Snapshot_Save, int64_t, int64_t, C, Streamed, ByImage)      \
+    YOSHI_ADD_BENCHMARK_IF((HasImage<AdaptedMap<int64_t, int64_t, C>>::value),                              \
+                           yoshi::manualTime(), Snapshot_Load, int64_t, int64_t, C, InMemory, ByImage)      \
+    YOSHI_ADD_BENCHMARK_IF((HasImage<AdaptedMap<int64_t, int64_t, C>>::value),                              \
+                           yoshi::manualTime(), Snapshot_Load, int64_t, int64_t, C, Streamed, ByImage)
+
+/// Writes of mostly existing keys through each call shape of the Adapter, with
+/// an allocated value (std::string) and a value counting its copies and moves
+#define DECLARE_UPSERT_TESTS(C) \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Upsert, int64_t, std::string, C, ByInsert)          \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Upsert, int64_t, std::string, C, ByEmplace)         \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Upsert, int64_t, std::string, C, ByTryEmplace)      \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Upsert, int64_t, std::string, C, ByInsertOrAssign)  \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Upsert, int64_t, std::string, C, BySubscript)       \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Upsert, int64_t, std::string, C, ByExtract)         \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Upsert, int64_t, Tracked<32>, C, ByInsert)          \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Upsert, int64_t, Tracked<32>, C, ByEmplace)         \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Upsert, int64_t, Tracked<32>, C, ByTryEmplace)      \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Upsert, int64_t, Tracked<32>, C, ByInsertOrAssign)  \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Upsert, int64_t, Tracked<32>, C, BySubscript)       \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Upsert, int64_t, Tracked<32>, C, ByExtract)
+
+/// Values of 8 to 512 bytes, trivially copyable (Blob) or counting their
+/// copies and moves (Tracked), with the short list of sizes to bound the memory
+#define DECLARE_PAYLOAD_TESTS(C) \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Insert_Random, int64_t, Blob<8>, C)         \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Find_Random, int64_t, Blob<8>, C)           \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Erase_Random, int64_t, Blob<8>, C)          \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Rehash, int64_t, Blob<8>, C)                \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Insert_Random, int64_t, Tracked<8>, C)      \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Erase_Random, int64_t, Tracked<8>, C)       \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Rehash, int64_t, Tracked<8>, C)             \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Growth_Timeline, int64_t, Tracked<8>, C)    \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Insert_Random, int64_t, Blob<32>, C)        \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Find_Random, int64_t, Blob<32>, C)          \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Erase_Random, int64_t, Blob<32>, C)         \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Rehash, int64_t, Blob<32>, C)               \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Insert_Random, int64_t, Tracked<32>, C)     \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Erase_Random, int64_t, Tracked<32>, C)      \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Rehash, int64_t, Tracked<32>, C)            \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Growth_Timeline, int64_t, Tracked<32>, C)   \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Insert_Random, int64_t, Blob<128>, C)       \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Find_Random, int64_t, Blob<128>, C)         \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Erase_Random, int64_t, Blob<128>, C)        \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Rehash, int64_t, Blob<128>, C)              \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Insert_Random, int64_t, Tracked<128>, C)    \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Erase_Random, int64_t, Tracked<128>, C)     \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Rehash, int64_t, Tracked<128>, C)           \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Growth_Timeline, int64_t, Tracked<128>, C)  \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Insert_Random, int64_t, Blob<512>, C)       \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Find_Random, int64_t, Blob<512>, C)         \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Erase_Random, int64_t, Blob<512>, C)        \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Rehash, int64_t, Blob<512>, C)              \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Insert_Random, int64_t, Tracked<512>, C)    \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Erase_Random, int64_t, Tracked<512>, C)     \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Rehash, int64_t, Tracked<512>, C)           \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Growth_Timeline, int64_t, Tracked<512>, C)
+
+/// String keys: short tickers stored inline (SSO), and heap allocated keys of
+/// fixed and variable lengths like composite identifiers
+#define DECLARE_STRING_TESTS(C) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Insert_String, std::string, int64_t, C, UniformLength<4, 12>)     \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Insert_String, std::string, int64_t, C, FixedLength<32>)          \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Insert_String, std::string, int64_t, C, UniformLength<16, 64>)    \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_String, std::string, int64_t, C, UniformLength<4, 12>)       \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_String, std::string, int64_t, C, FixedLength<32>)            \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_String, std::string, int64_t, C, UniformLength<16, 64>)      \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_String_View, std::string, int64_t, C, UniformLength<4, 12>)  \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_String_View, std::string, int64_t, C, FixedLength<32>)       \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_String_View, std::string, int64_t, C, UniformLength<16, 64>) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Erase_String, std::string, int64_t, C, UniformLength<4, 12>)      \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Erase_String, std::string, int64_t, C, FixedLength<32>)           \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Erase_String, std::string, int64_t, C, UniformLength<16, 64>)
+
+/// Declares all the tests for the hashmap C using the allocator template A,
+/// `name` being the alias template of the hashmap used in the benchmark names
+#define DECLARE_ALL_TESTS_WITH_ALLOCATOR(name, C, A) \
+    template <typename K, typename V> \
+    using name = AllocatedMap<C, A, K, V>; \
+    DECLARE_ALL_TESTS(name)
+
+/// Declares all the tests for the hashmap C using the hasher H (a template on
+/// the key type like std::hash), through the alias `name`. Compared with the
+/// default hasher of C it separates the cost of the hash from the probing.
+#define DECLARE_ALL_TESTS_WITH_HASHER(name, C, H) \
+    template <typename K, typename V> \
+    using name = HashedMap<C, H, K, V>; \
+    DECLARE_ALL_TESTS(name)
+
+/// Declares all the tests with each of the yoshi allocators, the aliases
+/// being named after `name`
+#define DECLARE_ALLOCATOR_TESTS(name, C) \
+    DECLARE_ALL_TESTS_WITH_ALLOCATOR(name##_arena, C, yoshi::ArenaAllocator)   \
+    DECLARE_ALL_TESTS_WITH_ALLOCATOR(name##_pool, C, yoshi::PoolAllocator)     \
+    DECLARE_ALL_TESTS_WITH_ALLOCATOR(name##_pmr, C, yoshi::PmrAllocator)       \
+    DECLARE_ALL_TESTS_WITH_ALLOCATOR(name##_hugepage, C, yoshi::HugePageAllocator)
+
+/// Lookups and updates with skewed key distributions: zipf with s = 0.99 and 1.2,
+/// 1% of the keys receiving 90% of the traffic and 16 ranges of contiguous keys
+#define DECLARE_SKEWED_TESTS(C) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_Random, int64_t, int64_t, C, ZipfKeys<99>)            \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_Random, int64_t, int64_t, C, ZipfKeys<120>)           \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_Random, int64_t, int64_t, C, HotColdKeys<1, 90>)      \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_Random, int64_t, int64_t, C, ClusteredKeys<16>)       \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_HalfHit, int64_t, int64_t, C, ZipfKeys<99>)           \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_HalfHit, int64_t, int64_t, C, HotColdKeys<1, 90>)     \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Insert_Erase_Random, int64_t, C, ZipfKeys<99>)       \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(yoshi::manualTime(), Insert_Erase_Random, int64_t, C, HotColdKeys<1, 90>)
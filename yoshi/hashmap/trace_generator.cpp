@@ -0,0 +1,82 @@
+#include "yoshi/trace.hpp"
+
+#include <boost/program_options.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <unordered_set>
+
+namespace po = boost::program_options;
+
+/// Writes a synthetic order book trace replayed by the Replay_Trace benchmark
+/// (hashmap --trace <file>)
+int main(int argc, char** argv)
+{
+    std::string output;
+    std::size_t count = 0;
+    yoshi::trace::Model model;
+    try
+    {
+        po::options_description desc{"Options"};
+        desc.add_options()
+        ("help,h", "Help screen")
+        ("output,o", po::value<std::string>(&output)->required(), "Trace file to write")
+        ("events,n", po::value<std::size_t>(&count)->default_value(1000000), "Number of events")
+        ("median-lifetime", po::value<double>(&model.medianLifetime)->default_value(model.medianLifetime),
+         "Median lifetime of the orders, in events")
+        ("sigma", po::value<double>(&model.sigma)->default_value(model.sigma),
+         "Standard deviation of the log of the lifetimes")
+        ("modifies", po::value<double>(&model.modifies)->default_value(model.modifies),
+         "Average number of modifications per order")
+        ("min-payload", po::value<std::uint32_t>(&model.minPayload)->default_value(model.minPayload),
+         "Minimum size of the orders in bytes")
+        ("max-payload", po::value<std::uint32_t>(&model.maxPayload)->default_value(model.maxPayload),
+         "Maximum size of the orders in bytes")
+        ("seed", po::value<std::uint64_t>(&model.seed)->default_value(model.seed), "Random seed");
+
+        po::variables_map vm;
+        po::store(parse_command_line(argc, argv, desc), vm);
+        if (vm.count("help"))
+        {
+            std::cout << desc << "\n";
+            return 0;
+        }
+        po::notify(vm);
+    }
+    catch (const po::error &ex)
+    {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+
+    const auto events = yoshi::trace::generate(count, model);
+    try
+    {
+        yoshi::trace::write(output, events);
+    }
+    catch (const std::exception& ex)
+    {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+
+    std::size_t ops[3] = {};
+    std::unordered_set<std::uint64_t> live;
+    std::size_t peak = 0;
+    for (const auto& e : events)
+    {
+        ++ops[static_cast<int>(e.op)];
+        if (e.op == yoshi::trace::Op::ADD)
+        {
+            live.insert(e.key);
+        }
+        else if (e.op == yoshi::trace::Op::CANCEL)
+        {
+            live.erase(e.key);
+        }
+        peak = std::max(peak, live.size());
+    }
+    std::cout << output << ": " << events.size() << " events, "
+              << ops[0] << " adds, " << ops[1] << " modifies, " << ops[2] << " cancels, "
+              << peak << " live orders at most\n";
+}
@@ -1,9 +1,158 @@
 #pragma once
 
+#include <string>
 #include <type_traits>
+#include <utility>
 
 template <typename K, typename V, template<typename ...> typename H>
 struct Traits
 {
     using SupportUnconditionnalRehash = std::false_type;
 };
+
+/// Detects if the hashmap C can prefetch the memory of a key (absl)
+template <typename C, typename K, typename = void>
+struct HasPrefetch : std::false_type {};
+
+template <typename C, typename K>
+struct HasPrefetch<C, K, std::void_t<decltype(std::declval<const C&>().prefetch(std::declval<K>()))>>
+    : std::true_type {};
+
+/// Detects if the hashmap C can hash a key ahead of the lookup, which
+/// also prefetches its memory (folly F14)
+template <typename C, typename K, typename = void>
+struct HasPrehash : std::false_type {};
+
+template <typename C, typename K>
+struct HasPrehash<C, K, std::void_t<decltype(std::declval<const C&>().prehash(std::declval<K>()))>>
+    : std::true_type {};
+
+/// Detects if the hashmap C can start loading the memory of a key ahead of
+/// its lookup (see Adapter::prefetch)
+template <typename C, typename K>
+struct CanPrefetch : std::disjunction<HasPrefetch<C, K>, HasPrehash<C, K>> {};
+
+/// Detects if the hashmap C can find a key from a L without converting it
+/// to its key type (transparent hasher and equality). The hasher and the
+/// equality are checked too: the find of absl is a template whatever they are,
+/// and its string hasher takes an absl::string_view, not always a std one.
+template <typename C, typename L, typename = void>
+struct HasHeterogeneousFind : std::false_type {};
+
+template <typename C, typename L>
+struct HasHeterogeneousFind<C, L, std::void_t<
+        decltype(std::declval<const C&>().find(std::declval<const L&>())),
+        decltype(std::declval<const typename C::hasher&>()(std::declval<const L&>())),
+        decltype(std::declval<const typename C::key_equal&>()(std::declval<const typename C::key_type&>(),
+                                                              std::declval<const L&>()))>>
+    : std::true_type {};
+
+/// Detects if the iterator It gives its value with it.value() (tsl, QHash)
+template <typename It, typename = void>
+struct HasIteratorValue : std::false_type {};
+
+template <typename It>
+struct HasIteratorValue<It, std::void_t<decltype(std::declval<const It&>().value())>>
+    : std::true_type {};
+
+/// Returns a reference on the value of the iterator `it` of a hashmap
+template <typename It>
+decltype(auto) mappedValue(const It& it)
+{
+    if constexpr (HasIteratorValue<It>::value)
+    {
+        return it.value();
+    }
+    else
+    {
+        return (it->second);
+    }
+}
+
+/// Returns a reference on the key of the iterator `it` of a hashmap
+template <typename It>
+decltype(auto) mappedKey(const It& it)
+{
+    if constexpr (HasIteratorValue<It>::value)
+    {
+        return it.key();
+    }
+    else
+    {
+        return (it->first);
+    }
+}
+
+/// Detects if the hashmap C can construct its element in place from a key and a value
+template <typename C, typename K, typename V, typename = void>
+struct HasEmplace : std::false_type {};
+
+template <typename C, typename K, typename V>
+struct HasEmplace<C, K, V, std::void_t<decltype(std::declval<C&>().emplace(std::declval<const K&>(), std::declval<const V&>()))>>
+    : std::true_type {};
+
+/// Detects if the hashmap C has try_emplace, which does not construct the
+/// element when the key is already there
+template <typename C, typename K, typename V, typename = void>
+struct HasTryEmplace : std::false_type {};
+
+template <typename C, typename K, typename V>
+struct HasTryEmplace<C, K, V, std::void_t<decltype(std::declval<C&>().try_emplace(std::declval<const K&>(), std::declval<const V&>()))>>
+    : std::true_type {};
+
+/// Detects if the hashmap C has insert_or_assign
+template <typename C, typename K, typename V, typename = void>
+struct HasInsertOrAssign : std::false_type {};
+
+template <typename C, typename K, typename V>
+struct HasInsertOrAssign<C, K, V, std::void_t<decltype(std::declval<C&>().insert_or_assign(std::declval<const K&>(), std::declval<const V&>()))>>
+    : std::true_type {};
+
+/// Detects if the hashmap C can extract the node of a key and insert it back
+/// (node handles of std::unordered_map, boost and absl)
+template <typename C, typename K, typename = void>
+struct HasExtract : std::false_type {};
+
+template <typename C, typename K>
+struct HasExtract<C, K, std::void_t<decltype(std::declval<C&>().insert(std::declval<C&>().extract(std::declval<const K&>())))>>
+    : std::true_type {};
+
+/// Detects if the allocator of the hashmap C is copy assignable, which is true
+/// for the hashmaps without allocator
+template <typename C, typename = void>
+struct HasAssignableAllocator : std::true_type {};
+
+template <typename C>
+struct HasAssignableAllocator<C, std::void_t<typename C::allocator_type>>
+    : std::is_copy_assignable<typename C::allocator_type> {};
+
+/// Detects if the node handles of the hashmap C can be used: the absl ones
+/// assign their allocator, which std::pmr::polymorphic_allocator does not
+/// allow (yoshi::PmrAllocator)
+template <typename C, typename K>
+struct HasNodeHandle
+    : std::conjunction<HasExtract<C, K>, HasAssignableAllocator<C>> {};
+
+/// Detects if the hashmap C lives in a file it can map again (yoshi::MappedMap)
+template <typename C, typename = void>
+struct IsFileMapped : std::false_type {};
+
+template <typename C>
+struct IsFileMapped<C, std::void_t<decltype(C::open(std::declval<const std::string&>()))>>
+    : std::true_type {};
+
+/// Detects if the table of the hashmap C has no pointer and can be copied as an
+/// image and rebuilt from it (yoshi::MappedMap)
+template <typename C, typename = void>
+struct HasImage : std::false_type {};
+
+template <typename C>
+struct HasImage<C, std::void_t<decltype(std::declval<const C&>().image())>>
+    : std::true_type {};
+
+/// Tells if the allocations of the hashmap C go through the operator new
+/// tracked by yoshi::memory. Specialized to false for the maps calling malloc
+/// (QHash), whose bytes are measured from the statistics of malloc (see
+/// yoshi::memory::heapLive) and whose numbers of allocations are not reported.
+template <typename C>
+struct TracksMemory : std::true_type {};
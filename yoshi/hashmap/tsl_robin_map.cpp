@@ -5,7 +5,8 @@
 
 // use a type alias else google::benchmark is having errors
 // because the name is getting too long!
-template<typename K, typename V>
-using tsl_robin_map = tsl::robin_map<K,V>;
+template<typename K, typename V, typename... Args>
+using tsl_robin_map = tsl::robin_map<K,V,Args...>;
 
 DECLARE_ALL_TESTS(tsl_robin_map)
+DECLARE_ALLOCATOR_TESTS(tsl_robin_map, tsl_robin_map)
@@ -0,0 +1,38 @@
+#include "flat_map.hpp"
+#include "tests.hpp"
+#include "traits.hpp"
+
+#include "yoshi/hash/hashers.hpp"
+
+template <typename K, typename V>
+struct Traits<K,V, yoshi::FlatMap>
+{
+    using SupportUnconditionnalRehash = std::true_type;
+};
+
+/// Keys and values in separate arrays
+template <typename K, typename V>
+using yoshi_flat_map_split = yoshi::FlatMap<K, V, std::hash<K>, std::equal_to<K>,
+                                            std::allocator<std::pair<const K, V>>,
+                                            yoshi::SplitLayout>;
+
+DECLARE_ALL_TESTS(yoshi::FlatMap)
+DECLARE_ALL_TESTS(yoshi_flat_map_split)
+DECLARE_ALLOCATOR_TESTS(yoshi_flat_map, yoshi::FlatMap)
+
+/// wyhash and transparent equality: the std::string keys can be found from a std::string_view
+template <typename K, typename V>
+using yoshi_flat_map_wyhash = yoshi::FlatMap<K, V, yoshi::WyHash<K>, std::equal_to<>>;
+
+DECLARE_ALL_TESTS(yoshi_flat_map_wyhash)
+
+#if defined(__AVX2__)
+/// Groups of 32 control bytes scanned with AVX2
+template <typename K, typename V>
+using yoshi_flat_map_avx2 = yoshi::FlatMap<K, V, std::hash<K>, std::equal_to<K>,
+                                           std::allocator<std::pair<const K, V>>,
+                                           yoshi::InterleavedLayout,
+                                           yoshi::flat_map::GroupAvx2>;
+
+DECLARE_ALL_TESTS(yoshi_flat_map_avx2)
+#endif
@@ -0,0 +1,11 @@
+#include "incremental_map.hpp"
+#include "tests.hpp"
+#include "traits.hpp"
+
+template <typename K, typename V>
+struct Traits<K,V, yoshi::IncrementalMap>
+{
+    using SupportUnconditionnalRehash = std::true_type;
+};
+
+DECLARE_ALL_TESTS(yoshi::IncrementalMap)
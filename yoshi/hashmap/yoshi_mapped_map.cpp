@@ -0,0 +1,12 @@
+#include "mapped_map.hpp"
+#include "tests.hpp"
+#include "traits.hpp"
+
+template <typename K, typename V>
+struct Traits<K,V, yoshi::MappedMap>
+{
+    using SupportUnconditionnalRehash = std::true_type;
+};
+
+/// In the heap for the usual benchmarks, Startup_FirstLookup maps it from a file
+DECLARE_TRIVIAL_TESTS(yoshi::MappedMap)
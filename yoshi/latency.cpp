@@ -0,0 +1,83 @@
+#include "latency.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace yoshi {
+namespace latency {
+
+double ticksPerNanosecond()
+{
+    static const double s_ticks = []
+    {
+        const auto begin = std::chrono::steady_clock::now();
+        const auto ticks = start();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const auto elapsed = stop() - ticks;
+        const auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+        return static_cast<double>(elapsed) / nanos;
+    }();
+    return s_ticks;
+}
+
+Histogram::Histogram()
+    : m_counts(index(~std::uint64_t(0)) + 1, 0)
+{
+}
+
+void Histogram::reset()
+{
+    std::fill(m_counts.begin(), m_counts.end(), 0);
+    m_count = 0;
+    m_max = 0;
+}
+
+std::uint64_t Histogram::highest(std::size_t index)
+{
+    if (index < 2 * SUB_BUCKETS)
+    {
+        return index;
+    }
+    const std::size_t shift = index / SUB_BUCKETS - 1;
+    const std::uint64_t top = index - shift * SUB_BUCKETS;
+    return ((top + 1) << shift) - 1;
+}
+
+std::uint64_t Histogram::percentile(double percentile) const
+{
+    const auto rank = static_cast<std::uint64_t>(percentile / 100.0 * m_count);
+    std::uint64_t total = 0;
+    for (std::size_t i = 0; i < m_counts.size(); ++i)
+    {
+        total += m_counts[i];
+        if (total > rank)
+        {
+            return std::min(highest(i), m_max);
+        }
+    }
+    return m_max;
+}
+
+Histogram& histogram()
+{
+    thread_local Histogram s_histogram;
+    return s_histogram;
+}
+
+void report(benchmark::State& state)
+{
+    const auto& h = histogram();
+    if (h.count() == 0)
+    {
+        return;
+    }
+    const double ticks = ticksPerNanosecond();
+    state.counters["p50_ns"] = h.percentile(50) / ticks;
+    state.counters["p99_ns"] = h.percentile(99) / ticks;
+    state.counters["p99.9_ns"] = h.percentile(99.9) / ticks;
+    state.counters["max_ns"] = h.max() / ticks;
+}
+
+}
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include "options.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace yoshi {
+namespace latency {
+
+/// Reads the time stamp counter, ordered with the previous instructions
+inline std::uint64_t start()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_lfence();
+    return __rdtsc();
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+/// Reads the time stamp counter once the previous instructions are done
+inline std::uint64_t stop()
+{
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int aux;
+    return __rdtscp(&aux);
+#else
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+/// Returns the number of ticks of start()/stop() per nanosecond,
+/// calibrated against the steady clock on the first call
+double ticksPerNanosecond();
+
+/// Log-linear histogram in the spirit of HdrHistogram: values below 64 have
+/// their own bucket, then each power of two is split in 32 buckets, so a
+/// value is recorded with a relative error below 1/32.
+class Histogram
+{
+public:
+    Histogram();
+
+    void add(std::uint64_t value)
+    {
+        ++m_counts[index(value)];
+        ++m_count;
+        m_max = value > m_max ? value : m_max;
+    }
+
+    void reset();
+
+    std::uint64_t count() const { return m_count; }
+    std::uint64_t max() const { return m_max; }
+    /// Returns the value below which `percentile` % of the values are
+    std::uint64_t percentile(double percentile) const;
+
+    static std::size_t index(std::uint64_t value)
+    {
+        if (value < 2 * SUB_BUCKETS)
+        {
+            return value;
+        }
+        const int magnitude = 63 - __builtin_clzll(value);
+        const int shift = magnitude - SUB_BITS;
+        return shift * SUB_BUCKETS + (value >> shift);
+    }
+
+    /// Returns the highest value recorded in the bucket
+    static std::uint64_t highest(std::size_t index);
+
+private:
+    static constexpr int SUB_BITS = 5;
+    static constexpr std::uint64_t SUB_BUCKETS = 1 << SUB_BITS;
+
+    std::vector<std::uint64_t> m_counts;
+    std::uint64_t m_count = 0;
+    std::uint64_t m_max = 0;
+};
+
+/// Returns the histogram of the current thread
+Histogram& histogram();
+
+/// Adds the p50/p99/p99.9/max latencies in nanoseconds of the histogram
+/// of the current thread to the benchmark user counters
+void report(benchmark::State& state);
+
+/// Calls `f` and records its latency in the histogram of the current thread
+/// if `Recording` is std::true_type. The latency mode (see yoshi::Options) is
+/// read once before the timed loop, which is compiled with and without the
+/// recording (see yoshi::runBatched), so it costs nothing when disabled.
+template <typename Recording, typename F>
+inline decltype(auto) record(Recording, F&& f)
+{
+    if constexpr (not Recording::value)
+    {
+        return f();
+    }
+    else
+    {
+        const auto begin = start();
+        if constexpr (std::is_void<decltype(f())>::value)
+        {
+            f();
+            histogram().add(stop() - begin);
+        }
+        else
+        {
+            decltype(auto) result = f();
+            histogram().add(stop() - begin);
+            return result;
+        }
+    }
+}
+}
+}
@@ -0,0 +1,186 @@
+#include "memory.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <new>
+#include <string>
+
+#include <malloc.h>
+
+namespace yoshi {
+namespace memory {
+namespace {
+std::atomic<bool> s_tracking{false};
+std::atomic<std::int64_t> s_live{0};
+std::atomic<std::int64_t> s_peak{0};
+std::atomic<std::int64_t> s_allocations{0};
+std::atomic<std::int64_t> s_deallocations{0};
+std::atomic<std::int64_t> s_allocated{0};
+/// Bytes in use by malloc when the tracking started
+std::atomic<std::int64_t> s_heap{0};
+
+void allocated(void* p)
+{
+    if (not s_tracking.load(std::memory_order_relaxed) or p == nullptr)
+    {
+        return;
+    }
+    const std::int64_t size = malloc_usable_size(p);
+    const auto live = s_live.fetch_add(size, std::memory_order_relaxed) + size;
+    s_allocated.fetch_add(size, std::memory_order_relaxed);
+    s_allocations.fetch_add(1, std::memory_order_relaxed);
+    auto peak = s_peak.load(std::memory_order_relaxed);
+    while (live > peak and not s_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+}
+
+void deallocated(void* p)
+{
+    if (not s_tracking.load(std::memory_order_relaxed) or p == nullptr)
+    {
+        return;
+    }
+    s_live.fetch_sub(malloc_usable_size(p), std::memory_order_relaxed);
+    s_deallocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+void* allocate(std::size_t size)
+{
+    void* p = std::malloc(size == 0 ? 1 : size);
+    if (p == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    allocated(p);
+    return p;
+}
+
+void* allocate(std::size_t size, std::align_val_t alignment)
+{
+    void* p = nullptr;
+    const auto align = std::max(sizeof(void*), static_cast<std::size_t>(alignment));
+    if (posix_memalign(&p, align, size == 0 ? 1 : size) != 0)
+    {
+        throw std::bad_alloc();
+    }
+    allocated(p);
+    return p;
+}
+
+void deallocate(void* p)
+{
+    deallocated(p);
+    std::free(p);
+}
+
+/// Returns the bytes in use by malloc, mmapped chunks included
+std::int64_t heapInUse()
+{
+    const auto info = mallinfo2();
+    return static_cast<std::int64_t>(info.uordblks + info.hblkhd);
+}
+
+/// Returns the value in bytes of the `field` of /proc/self/status, in kB in the
+/// file, -1 if not found
+std::int64_t statusBytes(const std::string& field)
+{
+    std::ifstream status("/proc/self/status");
+    std::string name;
+    while (status >> name)
+    {
+        if (name == field)
+        {
+            std::int64_t kilobytes = 0;
+            return status >> kilobytes ? kilobytes * 1024 : -1;
+        }
+        status.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    return -1;
+}
+}
+
+Stats stats()
+{
+    Stats result;
+    result.live = s_live.load();
+    result.peak = s_peak.load();
+    result.allocations = s_allocations.load();
+    result.deallocations = s_deallocations.load();
+    result.allocated = s_allocated.load();
+    return result;
+}
+
+std::int64_t heapLive()
+{
+    return heapInUse() - s_heap.load();
+}
+
+std::int64_t rss()
+{
+    return statusBytes("VmRSS:");
+}
+
+bool resetPeakRss()
+{
+    malloc_trim(0);
+    // 5 resets the peak resident set size, see proc(5)
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+    clearRefs.close();
+    return not clearRefs.fail();
+}
+
+std::int64_t peakRss()
+{
+    return statusBytes("VmHWM:");
+}
+
+Scope::Scope()
+{
+    s_live = 0;
+    s_peak = 0;
+    s_allocations = 0;
+    s_deallocations = 0;
+    s_allocated = 0;
+    s_heap = heapInUse();
+    s_tracking = true;
+}
+
+Scope::~Scope()
+{
+    s_tracking = false;
+}
+
+}
+}
+
+// Replace the global allocation functions so the allocations of all the
+// containers can be tracked, whatever their allocator is.
+void* operator new(std::size_t size) { return yoshi::memory::allocate(size); }
+void* operator new[](std::size_t size) { return yoshi::memory::allocate(size); }
+void* operator new(std::size_t size, std::align_val_t a) { return yoshi::memory::allocate(size, a); }
+void* operator new[](std::size_t size, std::align_val_t a) { return yoshi::memory::allocate(size, a); }
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return yoshi::memory::allocate(size); } catch (...) { return nullptr; }
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return yoshi::memory::allocate(size); } catch (...) { return nullptr; }
+}
+
+void operator delete(void* p) noexcept { yoshi::memory::deallocate(p); }
+void operator delete[](void* p) noexcept { yoshi::memory::deallocate(p); }
+void operator delete(void* p, std::size_t) noexcept { yoshi::memory::deallocate(p); }
+void operator delete[](void* p, std::size_t) noexcept { yoshi::memory::deallocate(p); }
+void operator delete(void* p, std::align_val_t) noexcept { yoshi::memory::deallocate(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { yoshi::memory::deallocate(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { yoshi::memory::deallocate(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { yoshi::memory::deallocate(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { yoshi::memory::deallocate(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { yoshi::memory::deallocate(p); }
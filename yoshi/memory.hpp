@@ -0,0 +1,103 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace yoshi {
+namespace memory {
+
+/// Allocation statistics gathered by the global operator new/delete of the
+/// yoshi library while the tracking is enabled (see Scope)
+struct Stats
+{
+    /// Bytes allocated and not freed yet
+    std::int64_t live = 0;
+    /// Highest value of live
+    std::int64_t peak = 0;
+    std::int64_t allocations = 0;
+    std::int64_t deallocations = 0;
+    /// Total of the bytes allocated
+    std::int64_t allocated = 0;
+};
+
+/// Returns the statistics since the tracking started
+Stats stats();
+
+/// Returns the bytes allocated by malloc and not freed since the tracking
+/// started, seen from the statistics of malloc: it also covers the memory not
+/// allocated by the operator new, but gives no number of allocations nor peak
+std::int64_t heapLive();
+
+/// Returns the resident set size of the process in bytes, -1 if unknown
+std::int64_t rss();
+
+/// Gives the memory freed by the process back to the system and resets the
+/// peak resident set size to the current one (linux only), returns false if it
+/// could not be reset
+bool resetPeakRss();
+
+/// Returns the peak resident set size of the process in bytes since the last
+/// resetPeakRss, -1 if unknown
+std::int64_t peakRss();
+
+/// Tracks all the allocations of the process during its lifetime.
+///
+/// The statistics are reset when the scope starts, and the tracking stops at
+/// the end of the scope. Memory freed while tracking which was allocated before
+/// makes `live` negative. Scopes can not be nested.
+class Scope
+{
+public:
+    Scope();
+    ~Scope();
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+};
+
+/// Returns the statistics shared by all the counting allocators
+inline Stats& countingStats()
+{
+    static Stats s_stats;
+    return s_stats;
+}
+
+/// Allocator forwarding to std::allocator and counting the memory of the
+/// containers using it (see countingStats), independently of the global tracking.
+/// Unlike the global tracking it counts the requested sizes, not the usable ones.
+template <typename T>
+struct CountingAllocator
+{
+    using value_type = T;
+
+    CountingAllocator() = default;
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>&) {}
+
+    T* allocate(std::size_t n)
+    {
+        auto& stats = countingStats();
+        stats.live += n * sizeof(T);
+        stats.allocated += n * sizeof(T);
+        stats.allocations += 1;
+        stats.peak = std::max(stats.peak, stats.live);
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        auto& stats = countingStats();
+        stats.live -= n * sizeof(T);
+        stats.deallocations += 1;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>&) const { return false; }
+};
+
+}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace yoshi {
+/// Runtime options shared by all the benchmarks, set from the command line
+/// by the yoshi main before running them
+struct Options
+{
+    /// Runs the short list of sizes
+    bool shortRun = false;
+    /// Collects the hardware performance counters on the timed regions
+    bool perfCounters = false;
+    /// Records the latency of each operation of the timed regions
+    bool latency = false;
+    /// Trace file replayed instead of a synthetic trace (see yoshi/trace.hpp)
+    std::string trace;
+    /// CSV file receiving the latency and memory of each operation of the
+    /// timeline benchmarks (see yoshi/timeline.hpp), none when empty
+    std::string timeline;
+    /// CPUs on which the threads of the multi-threaded benchmarks are pinned,
+    /// by thread index (see yoshi::ThreadPin), the CPUs allowed to the process
+    /// when empty
+    std::vector<int> cpus;
+};
+
+/// Returns the options of the current run
+Options& options();
+}
@@ -0,0 +1,5 @@
+#include "tests.hpp"
+
+#include "absl/container/btree_map.h"
+
+DECLARE_ALL_TESTS(absl::btree_map)
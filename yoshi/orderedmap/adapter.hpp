@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+
+/// Adapter in case ordered map implementation have different interface.
+///
+/// We assume the default implementation follows the interface of std::map.
+/// If this is not the case, you just need to partially specialize the Adapter.
+template <typename KeyType, typename ValueType, template<typename ...> typename OrderedMap>
+struct Adapter
+{
+    using Key = KeyType;
+    using Value = ValueType;
+    using C = OrderedMap<Key, Value>;
+
+    static auto insert(C& c, const KeyType& k, const ValueType& v) { return c.try_emplace(k, v).second; }
+    static auto erase(C& c, const KeyType& k) { return c.erase(k); }
+    static auto find(const C& c, const KeyType& k) { return c.find(k); }
+    static auto lowerBound(const C& c, const KeyType& k) { return c.lower_bound(k); }
+    static void clear(C& c) { c.clear(); }
+    static auto begin(const C& c) { return c.begin(); }
+    static auto end(const C& c) { return c.end(); }
+};
@@ -0,0 +1,6 @@
+#include "tests.hpp"
+
+#include <boost/container/flat_map.hpp>
+
+/// Sorted vector: the inserts and erases move half of the elements on average
+DECLARE_ALL_TESTS(boost::container::flat_map)
@@ -0,0 +1,347 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <new>
+#include <utility>
+
+namespace yoshi {
+
+/// Ordered map as an unrolled skip list: each node stores up to CAPACITY
+/// sorted elements in an array, followed by its tower of next pointers in the
+/// same allocation. Compared with a skip list of one element per node the
+/// lookups follow CAPACITY times less pointers and the scans read contiguous
+/// memory, like a B-tree leaf.
+///
+/// A full node is split in two halves on insertion, an empty node is removed
+/// (the nodes are not merged). Like boost::container::flat_map the elements are
+/// std::pair<K, V>, K and V must be default constructible. Inserting or erasing
+/// invalidates the iterators.
+template <typename K, typename V, typename Compare = std::less<K>>
+class SkipList
+{
+public:
+    using key_type = K;
+    using mapped_type = V;
+    using value_type = std::pair<K, V>;
+    using size_type = std::size_t;
+    using difference_type = std::ptrdiff_t;
+    using key_compare = Compare;
+
+    /// Elements per node: 16 pairs of 8 bytes integers fill 4 cache lines
+    static constexpr size_type CAPACITY = 16;
+    /// A node has a tower of height h + 1 with a probability of 1 / 4^h
+    static constexpr int MAX_HEIGHT = 16;
+
+private:
+    struct Node
+    {
+        std::uint32_t count = 0;
+        std::uint32_t height = 0;
+        std::array<value_type, CAPACITY> items;
+        /// height next pointers, allocated past the end of the node
+        Node* next[1];
+
+        const K& first() const { return items[0].first; }
+    };
+
+public:
+    template <bool Const>
+    class Iterator
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename SkipList::value_type;
+        using difference_type = std::ptrdiff_t;
+        using reference = std::conditional_t<Const, const value_type&, value_type&>;
+        using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+
+        Iterator() = default;
+
+        /// const_iterator from an iterator
+        template <bool C, typename = std::enable_if_t<Const and not C>>
+        Iterator(const Iterator<C>& other)
+            : m_node(other.m_node)
+            , m_index(other.m_index)
+        {
+        }
+
+        reference operator*() const { return m_node->items[m_index]; }
+        pointer operator->() const { return &m_node->items[m_index]; }
+
+        Iterator& operator++()
+        {
+            if (++m_index == m_node->count)
+            {
+                m_node = m_node->next[0];
+                m_index = 0;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int)
+        {
+            auto copy = *this;
+            ++*this;
+            return copy;
+        }
+
+        template <bool C>
+        bool operator==(const Iterator<C>& other) const
+        {
+            return m_node == other.m_node and m_index == other.m_index;
+        }
+        template <bool C>
+        bool operator!=(const Iterator<C>& other) const { return not (*this == other); }
+
+    private:
+        friend class SkipList;
+        template <bool> friend class Iterator;
+
+        Iterator(Node* node, std::uint32_t index)
+            : m_node(node)
+            , m_index(index)
+        {
+        }
+
+        Node* m_node = nullptr;
+        std::uint32_t m_index = 0;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+
+    SkipList()
+        : m_head(allocate(MAX_HEIGHT))
+    {
+    }
+
+    explicit SkipList(const Compare& compare)
+        : SkipList()
+    {
+        m_compare = compare;
+    }
+
+    SkipList(const SkipList&) = delete;
+    SkipList& operator=(const SkipList&) = delete;
+
+    ~SkipList()
+    {
+        clear();
+        deallocate(m_head);
+    }
+
+    iterator begin() { return iterator(m_head->next[0], 0); }
+    const_iterator begin() const { return const_iterator(m_head->next[0], 0); }
+    const_iterator cbegin() const { return begin(); }
+    iterator end() { return iterator(); }
+    const_iterator end() const { return const_iterator(); }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const { return m_size == 0; }
+    size_type size() const { return m_size; }
+    key_compare key_comp() const { return m_compare; }
+
+    iterator lower_bound(const K& key)
+    {
+        Node* path[MAX_HEIGHT];
+        return lowerBound(key, path);
+    }
+
+    const_iterator lower_bound(const K& key) const
+    {
+        return const_cast<SkipList*>(this)->lower_bound(key);
+    }
+
+    iterator find(const K& key)
+    {
+        auto it = lower_bound(key);
+        return it != end() and not m_compare(key, it->first) ? it : end();
+    }
+
+    const_iterator find(const K& key) const
+    {
+        return const_cast<SkipList*>(this)->find(key);
+    }
+
+    bool contains(const K& key) const { return find(key) != end(); }
+    size_type count(const K& key) const { return contains(key) ? 1 : 0; }
+
+    std::pair<iterator, bool> insert(const value_type& value) { return try_emplace(value.first, value.second); }
+    std::pair<iterator, bool> insert(value_type&& value) { return try_emplace(value.first, std::move(value.second)); }
+
+    template <typename... Args>
+    std::pair<iterator, bool> try_emplace(const K& key, Args&&... args)
+    {
+        Node* path[MAX_HEIGHT];
+        auto it = lowerBound(key, path);
+        if (it != end() and not m_compare(key, it->first))
+        {
+            return {it, false};
+        }
+        // inserted in the last node starting before the key, or at the
+        // beginning of the first node when the key is the smallest one
+        Node* node = path[0] != m_head ? path[0] : m_head->next[0];
+        std::uint32_t index = 0;
+        if (node == nullptr)
+        {
+            node = allocate(randomHeight());
+            link(node, path);
+        }
+        else if (node == path[0])
+        {
+            index = it.m_node == node ? it.m_index : node->count;
+        }
+        if (node->count == CAPACITY)
+        {
+            Node* upper = split(node, path);
+            if (index > node->count)
+            {
+                index -= node->count;
+                node = upper;
+            }
+        }
+        std::move_backward(node->items.begin() + index, node->items.begin() + node->count,
+                           node->items.begin() + node->count + 1);
+        node->items[index] = value_type(key, V(std::forward<Args>(args)...));
+        ++node->count;
+        ++m_size;
+        return {iterator(node, index), true};
+    }
+
+    V& operator[](const K& key) { return try_emplace(key).first->second; }
+
+    size_type erase(const K& key)
+    {
+        Node* path[MAX_HEIGHT];
+        auto it = lowerBound(key, path);
+        if (it == end() or m_compare(key, it->first))
+        {
+            return 0;
+        }
+        Node* node = it.m_node;
+        std::move(node->items.begin() + it.m_index + 1, node->items.begin() + node->count,
+                  node->items.begin() + it.m_index);
+        --node->count;
+        --m_size;
+        if (node->count == 0)
+        {
+            // the key was the only one of the node so the path ends right before it
+            for (std::uint32_t level = 0; level < node->height; ++level)
+            {
+                path[level]->next[level] = node->next[level];
+            }
+            deallocate(node);
+        }
+        else
+        {
+            node->items[node->count] = value_type();
+        }
+        return 1;
+    }
+
+    void clear()
+    {
+        Node* node = m_head->next[0];
+        while (node != nullptr)
+        {
+            Node* next = node->next[0];
+            deallocate(node);
+            node = next;
+        }
+        std::fill(m_head->next, m_head->next + MAX_HEIGHT, nullptr);
+        m_size = 0;
+    }
+
+private:
+    static Node* allocate(std::uint32_t height)
+    {
+        void* memory = ::operator new(sizeof(Node) + (height - 1) * sizeof(Node*));
+        Node* node = new (memory) Node();
+        node->height = height;
+        std::fill(node->next, node->next + height, nullptr);
+        return node;
+    }
+
+    static void deallocate(Node* node)
+    {
+        node->~Node();
+        ::operator delete(node);
+    }
+
+    std::uint32_t randomHeight()
+    {
+        // xorshift64, two bits per level
+        m_random ^= m_random << 13;
+        m_random ^= m_random >> 7;
+        m_random ^= m_random << 17;
+        const int zeros = __builtin_ctzll(m_random | (std::uint64_t(1) << 62));
+        return std::min(zeros / 2 + 1, MAX_HEIGHT);
+    }
+
+    /// Returns the first element not less than key, and fills path with the last
+    /// node of each level starting before the key (the head if none)
+    iterator lowerBound(const K& key, Node** path)
+    {
+        Node* node = m_head;
+        for (int level = MAX_HEIGHT - 1; level >= 0; --level)
+        {
+            while (node->next[level] != nullptr and m_compare(node->next[level]->first(), key))
+            {
+                node = node->next[level];
+            }
+            path[level] = node;
+        }
+        if (node != m_head)
+        {
+            auto it = std::lower_bound(node->items.begin(), node->items.begin() + node->count, key,
+                                       [this](const value_type& item, const K& k) { return m_compare(item.first, k); });
+            if (it != node->items.begin() + node->count)
+            {
+                return iterator(node, it - node->items.begin());
+            }
+        }
+        return iterator(node->next[0], 0);
+    }
+
+    /// Links the first node of the list
+    void link(Node* node, Node** path)
+    {
+        for (std::uint32_t level = 0; level < node->height; ++level)
+        {
+            node->next[level] = path[level]->next[level];
+            path[level]->next[level] = node;
+        }
+    }
+
+    /// Moves the upper half of the full node to a new node linked after it,
+    /// path being the one of a key in node or before its first key
+    Node* split(Node* node, Node** path)
+    {
+        Node* upper = allocate(randomHeight());
+        const std::uint32_t half = CAPACITY / 2;
+        std::move(node->items.begin() + half, node->items.end(), upper->items.begin());
+        std::fill(node->items.begin() + half, node->items.end(), value_type());
+        upper->count = CAPACITY - half;
+        node->count = half;
+        for (std::uint32_t level = 0; level < upper->height; ++level)
+        {
+            Node* previous = level < node->height ? node : path[level];
+            upper->next[level] = previous->next[level];
+            previous->next[level] = upper;
+        }
+        return upper;
+    }
+
+    /// Sentinel with MAX_HEIGHT next pointers and no element
+    Node* m_head;
+    size_type m_size = 0;
+    std::uint64_t m_random = 0x9e3779b97f4a7c15;
+    Compare m_compare;
+};
+
+}
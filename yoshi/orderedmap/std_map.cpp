@@ -0,0 +1,5 @@
+#include "tests.hpp"
+
+#include <map>
+
+DECLARE_ALL_TESTS(std::map)
@@ -0,0 +1,265 @@
+#pragma once
+
+#include "adapter.hpp"
+
+#include "yoshi/harness.hpp"
+#include "yoshi/latency.hpp"
+#include "yoshi/yoshi.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/// Fills keys with [0, count -1] in a random order
+template <typename K>
+void shuffledKeys(std::vector<K>& keys, int64_t count, std::mt19937_64& generator)
+{
+    keys.clear();
+    for(K i = 0; i < count; ++i)
+    {
+        keys.push_back(i);
+    }
+    std::shuffle(keys.begin(), keys.end(), generator);
+}
+
+/// Throws if the benchmark did not find the expected number of elements
+inline void checkFound(int64_t expected, int64_t found)
+{
+    if (found != expected)
+    {
+        throw std::runtime_error("excepted " + std::to_string(expected) + " found " + std::to_string(found));
+    }
+}
+
+/// Inserts [0, state.range(0) -1] in random order, the value being the key
+template <typename K, typename V, template<typename ...> typename M>
+void Insert_Random(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, M>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        Type c;
+        std::vector<K> keys;
+    };
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
+        {
+            shuffledKeys(instance.keys, state.range(0), generator);
+            AdapterT::clear(instance.c);
+        },
+        [&](Instance& instance, auto recording)
+        {
+            for (auto key : instance.keys)
+            {
+                yoshi::latency::record(recording, [&] { return AdapterT::insert(instance.c, key, key); });
+            }
+        },
+        [](Instance&) {});
+}
+
+/// Inserts [0, state.range(0) -1] in random order and measure the time
+/// to erase all of them in another random order
+template <typename K, typename V, template<typename ...> typename M>
+void Erase_Random(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, M>;
+    using Type = typename AdapterT::C;
+    struct Instance
+    {
+        Type c;
+        std::vector<K> keys;
+        int64_t erased = 0;
+    };
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
+        {
+            shuffledKeys(instance.keys, state.range(0), generator);
+            AdapterT::clear(instance.c);
+            for (auto key : instance.keys)
+            {
+                AdapterT::insert(instance.c, key, key);
+            }
+            std::shuffle(instance.keys.begin(), instance.keys.end(), generator);
+            instance.erased = 0;
+        },
+        [&](Instance& instance, auto recording)
+        {
+            for (auto key : instance.keys)
+            {
+                instance.erased += yoshi::latency::record(recording, [&] { return AdapterT::erase(instance.c, key); });
+            }
+        },
+        [&](Instance& instance) { checkFound(state.range(0), instance.erased); });
+}
+
+/// Map of the state.range(0) keys [0, state.range(0) -1] (times `step`)
+/// inserted in random order, built once for all the batches of the read only
+/// benchmarks
+template <typename K, typename V, template<typename ...> typename M>
+struct ReadInstance
+{
+    typename Adapter<K, V, M>::C c;
+    bool built = false;
+    std::vector<K> lookups;
+    int64_t found = 0;
+    /// found by the benchmark when it depends on the lookups
+    int64_t expected = 0;
+
+    void build(int64_t count, K step, std::mt19937_64& generator)
+    {
+        if (not built)
+        {
+            shuffledKeys(lookups, count, generator);
+            for (auto key : lookups)
+            {
+                Adapter<K, V, M>::insert(c, key * step, key * step);
+            }
+            built = true;
+        }
+        found = 0;
+    }
+};
+
+/// Inserts [0, state.range(0) -1] in random order and measure the time
+/// to find all of them in another random order
+template <typename K, typename V, template<typename ...> typename M>
+void Find_Random(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, M>;
+    using Instance = ReadInstance<K, V, M>;
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
+        {
+            instance.build(state.range(0), 1, generator);
+            std::shuffle(instance.lookups.begin(), instance.lookups.end(), generator);
+        },
+        [&](Instance& instance, auto recording)
+        {
+            for (auto key : instance.lookups)
+            {
+                auto it = yoshi::latency::record(recording, [&] { return AdapterT::find(instance.c, key); });
+                instance.found += (it != AdapterT::end(instance.c));
+            }
+        },
+        [&](Instance& instance) { checkFound(state.range(0), instance.found); });
+}
+
+/// Inserts the even keys [0, 2 * (state.range(0) -1)] in random order and
+/// measure the time to find the lower bound of the odd keys in random order,
+/// so each lookup ends between 2 elements
+template <typename K, typename V, template<typename ...> typename M>
+void LowerBound_Random(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, M>;
+    using Instance = ReadInstance<K, V, M>;
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance)
+        {
+            instance.build(state.range(0), 2, generator);
+            std::shuffle(instance.lookups.begin(), instance.lookups.end(), generator);
+        },
+        [&](Instance& instance, auto recording)
+        {
+            for (auto key : instance.lookups)
+            {
+                auto it = yoshi::latency::record(recording, [&] { return AdapterT::lowerBound(instance.c, 2 * key + 1); });
+                // the largest key has no lower bound
+                instance.found += (it != AdapterT::end(instance.c) and it->first == 2 * key + 2);
+            }
+        },
+        [&](Instance& instance) { checkFound(state.range(0) - 1, instance.found); });
+}
+
+/// Applies the arguments of the range scans: for each size the number of
+/// elements read by each scan
+inline void scanArgs(benchmark::internal::Benchmark* b, const std::vector<int64_t>& sizes)
+{
+    for (auto size : sizes)
+    {
+        for (int64_t length : {16, 256})
+        {
+            b->Args({size, length});
+        }
+    }
+}
+
+/// Inserts [0, state.range(0) -1] in random order and measure the time to
+/// read the values of state.range(1) consecutive elements from the lower bound
+/// of random keys, state.range(0) / state.range(1) times
+template <typename K, typename V, template<typename ...> typename M>
+void Range_Scan(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, M>;
+    using Instance = ReadInstance<K, V, M>;
+    const int64_t length = state.range(1);
+    const int64_t scans = std::max<int64_t>(state.range(0) / length, 1);
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    int64_t sum = 0;
+    yoshi::runBatched<Instance>(state, scans * length,
+        [&](Instance& instance)
+        {
+            instance.build(state.range(0), 1, generator);
+            std::shuffle(instance.lookups.begin(), instance.lookups.end(), generator);
+            instance.expected = 0;
+            for (int64_t i = 0; i < scans; ++i)
+            {
+                instance.expected += std::min(length, state.range(0) - instance.lookups[i]);
+            }
+        },
+        [&](Instance& instance)
+        {
+            for (int64_t i = 0; i < scans; ++i)
+            {
+                auto it = AdapterT::lowerBound(instance.c, instance.lookups[i]);
+                const auto end = AdapterT::end(instance.c);
+                for (int64_t j = 0; j < length and it != end; ++j, ++it)
+                {
+                    sum += it->second;
+                    ++instance.found;
+                }
+            }
+        },
+        [](Instance& instance) { checkFound(instance.expected, instance.found); });
+    benchmark::DoNotOptimize(sum);
+}
+
+/// Inserts [0, state.range(0) -1] in random order and measure the time to
+/// read all the values in order
+template <typename K, typename V, template<typename ...> typename M>
+void Iterate(benchmark::State& state)
+{
+    using AdapterT = Adapter<K, V, M>;
+    using Instance = ReadInstance<K, V, M>;
+    const std::int64_t SEED = 0;
+    std::mt19937_64 generator(SEED);
+    yoshi::runBatched<Instance>(state, state.range(0),
+        [&](Instance& instance) { instance.build(state.range(0), 1, generator); },
+        [&](Instance& instance)
+        {
+            for (auto it = AdapterT::begin(instance.c); it != AdapterT::end(instance.c); ++it)
+            {
+                instance.found += it->second;
+            }
+        },
+        [&](Instance& instance) { checkFound(state.range(0) * (state.range(0) - 1) / 2, instance.found); });
+}
+
+#define DECLARE_ALL_TESTS(C) \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Insert_Random, int64_t, int64_t, C)         \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Erase_Random, int64_t, int64_t, C)          \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Find_Random, int64_t, int64_t, C)           \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), LowerBound_Random, int64_t, int64_t, C)     \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(scanArgs), Range_Scan, int64_t, int64_t, C)    \
+    YOSHI_ADD_BENCHMARK_WITH(yoshi::manualTime(), Iterate, int64_t, int64_t, C)
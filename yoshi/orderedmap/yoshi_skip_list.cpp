@@ -0,0 +1,4 @@
+#include "skip_list.hpp"
+#include "tests.hpp"
+
+DECLARE_ALL_TESTS(yoshi::SkipList)
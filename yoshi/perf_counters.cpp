@@ -0,0 +1,171 @@
+#include "perf_counters.hpp"
+
+#include <iostream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace yoshi {
+namespace {
+/// Names of the user counters, in the order of PerfCounters::Event
+const char* const NAMES[PerfCounters::EVENT_COUNT] = {
+    "L1D_misses",
+    "LLC_misses",
+    "dTLB_misses",
+    "branch_misses",
+    "instructions",
+};
+
+#ifdef __linux__
+std::uint64_t cacheMiss(std::uint64_t cache)
+{
+    return cache
+        | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+        | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+}
+
+int openEvent(std::uint32_t type, std::uint64_t config, int leader)
+{
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (leader == -1);
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID
+        | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+}
+#endif
+}
+
+PerfCounters& PerfCounters::instance()
+{
+    thread_local PerfCounters s_instance;
+    return s_instance;
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (auto fd : m_fds)
+    {
+        if (fd != -1)
+        {
+            close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::open()
+{
+#ifdef __linux__
+    if (m_opened)
+    {
+        return m_leader != -1;
+    }
+    m_opened = true;
+    const std::pair<std::uint32_t, std::uint64_t> events[EVENT_COUNT] = {
+        {PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_L1D)},
+        {PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_LL)},
+        {PERF_TYPE_HW_CACHE, cacheMiss(PERF_COUNT_HW_CACHE_DTLB)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    };
+    for (int i = 0; i < EVENT_COUNT; ++i)
+    {
+        m_fds[i] = openEvent(events[i].first, events[i].second, m_leader);
+        if (m_fds[i] == -1)
+        {
+            std::cerr << "yoshi: performance counter " << NAMES[i] << " not available\n";
+        }
+        else if (m_leader == -1)
+        {
+            m_leader = m_fds[i];
+        }
+    }
+    return m_leader != -1;
+#else
+    std::cerr << "yoshi: performance counters are only supported on linux\n";
+    return false;
+#endif
+}
+
+void PerfCounters::reset()
+{
+#ifdef __linux__
+    if (m_leader != -1)
+    {
+        ioctl(m_leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+void PerfCounters::start()
+{
+#ifdef __linux__
+    if (m_leader != -1)
+    {
+        ioctl(m_leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+void PerfCounters::stop()
+{
+#ifdef __linux__
+    if (m_leader != -1)
+    {
+        ioctl(m_leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+void PerfCounters::report(benchmark::State& state)
+{
+    const double operations = static_cast<double>(m_operations > 0 ? m_operations : state.range(0));
+    m_operations = 0;
+#ifdef __linux__
+    if (m_leader == -1)
+    {
+        return;
+    }
+    // nr, time_enabled, time_running, then a (value, id) pair per event
+    std::uint64_t data[3 + 2 * EVENT_COUNT] = {};
+    if (read(m_leader, data, sizeof(data)) <= 0)
+    {
+        return;
+    }
+    const auto enabled = data[1];
+    const auto running = data[2];
+    // the benchmark never started the counters, there is nothing to report
+    if (running == 0)
+    {
+        return;
+    }
+    // scale the values if the events got multiplexed with other ones
+    const double scale = static_cast<double>(enabled) / running;
+    for (std::uint64_t e = 0; e < data[0]; ++e)
+    {
+        const auto value = data[3 + 2 * e];
+        const auto id = data[3 + 2 * e + 1];
+        for (int i = 0; i < EVENT_COUNT; ++i)
+        {
+            std::uint64_t eventId = 0;
+            if (m_fds[i] != -1 and ioctl(m_fds[i], PERF_EVENT_IOC_ID, &eventId) == 0 and eventId == id)
+            {
+                state.counters[NAMES[i]] = benchmark::Counter(
+                    value * scale / operations,
+                    benchmark::Counter::kAvgIterations);
+            }
+        }
+    }
+#endif
+}
+}
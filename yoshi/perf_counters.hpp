@@ -0,0 +1,60 @@
+#pragma once
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+namespace yoshi {
+/// Hardware performance counters of the current thread (perf_event_open).
+///
+/// The counters are opened and reset before each benchmark and reported after
+/// it, and only run between start() and stop(): yoshi::runBatched and
+/// yoshi::runInstances call them around their timed region, the benchmarks
+/// timing themselves call them around their timed loop. A benchmark which never
+/// starts them reports no counter. If the counters can not be opened (no linux,
+/// perf_event_paranoid...) everything is a no-op.
+class PerfCounters
+{
+public:
+    enum Event
+    {
+        L1D_MISSES,
+        LLC_MISSES,
+        DTLB_MISSES,
+        BRANCH_MISSES,
+        INSTRUCTIONS,
+        EVENT_COUNT
+    };
+
+    /// Returns the counters of the current thread
+    static PerfCounters& instance();
+
+    ~PerfCounters();
+
+    /// Opens the counters, returns false if they are not available
+    bool open();
+    /// Sets all the counters back to 0
+    void reset();
+    void start();
+    void stop();
+    /// Sets the number of operations of an iteration for the next report, when
+    /// it is not state.range(0)
+    void setOperations(std::int64_t operations) { m_operations = operations; }
+    /// Adds the values of the counters divided by the number of operations
+    /// (state.range(0) per iteration unless set) to the benchmark user counters
+    void report(benchmark::State& state);
+
+private:
+    PerfCounters() = default;
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /// File descriptors of the events, -1 if not available; the first opened
+    /// one is the group leader
+    int m_fds[EVENT_COUNT] = {-1, -1, -1, -1, -1};
+    int m_leader = -1;
+    bool m_opened = false;
+    /// Operations of an iteration set for the next report, 0 for state.range(0)
+    std::int64_t m_operations = 0;
+};
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+/// Adapter for the queues shared between threads.
+///
+/// The default implementation follows the interface of boost::lockfree (the
+/// capacity given to the constructor, push and pop returning false when the
+/// queue is full or empty), other implementations need to partially
+/// specialize it. push and pop must not block.
+template <typename T, template<typename ...> typename Queue>
+struct Adapter
+{
+    using Value = T;
+    using C = Queue<T>;
+
+    static auto create(std::size_t capacity) { return std::make_unique<C>(capacity); }
+    static bool push(C& c, const T& value) { return c.push(value); }
+    static bool pop(C& c, T& value) { return c.pop(value); }
+};
@@ -0,0 +1,7 @@
+#include "tests.hpp"
+
+#include <boost/lockfree/queue.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+
+DECLARE_SPSC_TESTS(boost::lockfree::spsc_queue)
+DECLARE_MPMC_TESTS(boost::lockfree::queue)
@@ -0,0 +1,35 @@
+#include "tests.hpp"
+
+#include "folly/MPMCQueue.h"
+#include "folly/ProducerConsumerQueue.h"
+
+// use a type alias since the MPMCQueue has non-type template parameters
+template <typename T>
+using folly_mpmc_queue = folly::MPMCQueue<T>;
+
+/// Specialize the adapter since the folly queues write and read
+template <typename T>
+struct Adapter<T, folly::ProducerConsumerQueue>
+{
+    using Value = T;
+    using C = folly::ProducerConsumerQueue<T>;
+
+    // one slot of the ring stays empty
+    static auto create(std::size_t capacity) { return std::make_unique<C>(capacity + 1); }
+    static bool push(C& c, const T& value) { return c.write(value); }
+    static bool pop(C& c, T& value) { return c.read(value); }
+};
+
+template <typename T>
+struct Adapter<T, folly_mpmc_queue>
+{
+    using Value = T;
+    using C = folly_mpmc_queue<T>;
+
+    static auto create(std::size_t capacity) { return std::make_unique<C>(capacity); }
+    static bool push(C& c, const T& value) { return c.write(value); }
+    static bool pop(C& c, T& value) { return c.read(value); }
+};
+
+DECLARE_SPSC_TESTS(folly::ProducerConsumerQueue)
+DECLARE_MPMC_TESTS(folly_mpmc_queue)
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+
+namespace yoshi {
+
+/// std::deque protected by a mutex, the baseline of the queues. It is not
+/// bounded: the capacity is only given for the interface of the other queues.
+template <typename T>
+class LockedQueue
+{
+public:
+    explicit LockedQueue(std::size_t) {}
+
+    bool push(const T& value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_items.push_back(value);
+        return true;
+    }
+
+    bool pop(T& value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (m_items.empty())
+        {
+            return false;
+        }
+        value = m_items.front();
+        m_items.pop_front();
+        return true;
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<T> m_items;
+};
+
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace yoshi {
+
+/// Bounded queue for one producer and one consumer thread.
+///
+/// The producer owns the head and the consumer the tail, each one on its own
+/// cache line with a copy of the other index: the shared index is only read
+/// again when the copy says the ring is full (or empty), so in steady state
+/// the threads only exchange the cache lines of the elements.
+template <typename T>
+class SpscRing
+{
+public:
+    /// The capacity is rounded up to a power of two
+    explicit SpscRing(std::size_t capacity)
+        : m_mask(roundUp(capacity) - 1)
+        , m_items(m_mask + 1)
+    {
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    std::size_t capacity() const { return m_mask + 1; }
+
+    /// Returns false if the ring is full, producer thread only
+    bool push(const T& value)
+    {
+        const auto head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tailCache == capacity())
+        {
+            m_tailCache = m_tail.load(std::memory_order_acquire);
+            if (head - m_tailCache == capacity())
+            {
+                return false;
+            }
+        }
+        m_items[head & m_mask] = value;
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Returns false if the ring is empty, consumer thread only
+    bool pop(T& value)
+    {
+        const auto tail = m_tail.load(std::memory_order_relaxed);
+        if (tail == m_headCache)
+        {
+            m_headCache = m_head.load(std::memory_order_acquire);
+            if (tail == m_headCache)
+            {
+                return false;
+            }
+        }
+        value = std::move(m_items[tail & m_mask]);
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    static std::size_t roundUp(std::size_t capacity)
+    {
+        std::size_t power = 1;
+        while (power < capacity)
+        {
+            power *= 2;
+        }
+        return power;
+    }
+
+    /// next element pushed, and the last tail seen by the producer
+    alignas(64) std::atomic<std::size_t> m_head{0};
+    std::size_t m_tailCache = 0;
+    /// next element popped, and the last head seen by the consumer
+    alignas(64) std::atomic<std::size_t> m_tail{0};
+    std::size_t m_headCache = 0;
+    alignas(64) const std::size_t m_mask;
+    std::vector<T> m_items;
+};
+
+}
@@ -0,0 +1,4 @@
+#include "locked_queue.hpp"
+#include "tests.hpp"
+
+DECLARE_MPMC_TESTS(yoshi::LockedQueue)
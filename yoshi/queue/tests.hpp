@@ -0,0 +1,184 @@
+#pragma once
+
+#include "adapter.hpp"
+
+#include "yoshi/affinity.hpp"
+#include "yoshi/latency.hpp"
+#include "yoshi/perf_counters.hpp"
+#include "yoshi/yoshi.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+/// Capacity of the bounded queues
+constexpr int64_t QUEUE_CAPACITY = 1024;
+/// Number of messages sent by each producer per iteration of the throughput
+constexpr int64_t QUEUE_MESSAGES = 4096;
+
+/// Waits a bit before trying again on a full or empty queue, yielding from
+/// time to time so the threads sharing a CPU still progress
+inline void backoff(int& spins)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+    if (++spins % 1024 == 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+template <typename T, template<typename ...> typename Q>
+void push(typename Adapter<T, Q>::C& c, const T& value)
+{
+    for (int spins = 0; not Adapter<T, Q>::push(c, value); )
+    {
+        backoff(spins);
+    }
+}
+
+template <typename T, template<typename ...> typename Q>
+T pop(typename Adapter<T, Q>::C& c)
+{
+    T value;
+    for (int spins = 0; not Adapter<T, Q>::pop(c, value); )
+    {
+        backoff(spins);
+    }
+    return value;
+}
+
+/// Applies the arguments of the round trip and of the throughput with a
+/// single producer: the capacity and 2 threads
+inline void spscArgs(benchmark::internal::Benchmark* b, const std::vector<int64_t>&)
+{
+    b->Arg(QUEUE_CAPACITY)->Threads(2)->UseRealTime();
+}
+
+/// Applies the arguments of the throughput with 1 to N producers, N being
+/// the number of pinned CPUs (see yoshi::pinnedCpus) minus the consumer
+inline void mpscArgs(benchmark::internal::Benchmark* b, const std::vector<int64_t>&)
+{
+    const int cpus = yoshi::pinnedCpus().size();
+    b->Arg(QUEUE_CAPACITY)->DenseThreadRange(2, std::max(2, cpus))->UseRealTime();
+}
+
+/// Sends a timestamp from the thread 0 to the thread 1 which sends it back on
+/// a second queue, and reports the percentiles of the round trip latency. The
+/// threads are pinned on the first two CPUs of yoshi::pinnedCpus, to compare the
+/// same core (hyperthreads), same socket and cross socket placements.
+template <typename T, template<typename ...> typename Q>
+void RoundTrip_Latency(benchmark::State& state)
+{
+    using AdapterT = Adapter<T, Q>;
+    using Type = typename AdapterT::C;
+    // shared by the 2 threads, created and destroyed by the first one
+    static std::unique_ptr<Type> s_ping;
+    static std::unique_ptr<Type> s_pong;
+
+    yoshi::ThreadPin pin(state.thread_index());
+    auto& histogram = yoshi::latency::histogram();
+    if (state.thread_index() == 0)
+    {
+        s_ping = AdapterT::create(state.range(0));
+        s_pong = AdapterT::create(state.range(0));
+        histogram.reset();
+    }
+    // both threads wait for each other before starting the loop
+    yoshi::PerfCounters::instance().start();
+    for (auto _ : state)
+    {
+        if (state.thread_index() == 0)
+        {
+            const T begin = yoshi::latency::start();
+            push<T, Q>(*s_ping, begin);
+            const auto end = pop<T, Q>(*s_pong);
+            histogram.add(yoshi::latency::stop() - end);
+        }
+        else
+        {
+            push<T, Q>(*s_pong, pop<T, Q>(*s_ping));
+        }
+    }
+    yoshi::PerfCounters::instance().stop();
+    yoshi::PerfCounters::instance().setOperations(1);
+    if (state.thread_index() == 0)
+    {
+        yoshi::latency::report(state);
+        s_ping.reset();
+        s_pong.reset();
+    }
+}
+
+/// The thread 0 pops the messages of all the other threads, each one pushing
+/// QUEUE_MESSAGES per iteration, and the throughput is the number of messages
+/// per second. The threads are pinned by index on yoshi::pinnedCpus,
+/// the consumer checks the messages of each producer arrive in order.
+template <typename T, template<typename ...> typename Q>
+void Throughput(benchmark::State& state)
+{
+    using AdapterT = Adapter<T, Q>;
+    using Type = typename AdapterT::C;
+    static std::unique_ptr<Type> s_queue;
+
+    yoshi::ThreadPin pin(state.thread_index());
+    const T producers = state.threads() - 1;
+    if (state.thread_index() == 0)
+    {
+        s_queue = AdapterT::create(state.range(0));
+    }
+    // each message is its sequence number times the producers plus its producer
+    std::vector<T> next(producers, 0);
+    T sequence = 0;
+    bool ordered = true;
+    yoshi::PerfCounters::instance().start();
+    for (auto _ : state)
+    {
+        if (state.thread_index() == 0)
+        {
+            for (int64_t i = 0; i < QUEUE_MESSAGES * producers; ++i)
+            {
+                const auto message = pop<T, Q>(*s_queue);
+                auto& expected = next[message % producers];
+                ordered &= (message / producers == expected);
+                expected = message / producers + 1;
+            }
+        }
+        else
+        {
+            for (int64_t i = 0; i < QUEUE_MESSAGES; ++i)
+            {
+                push<T, Q>(*s_queue, sequence++ * producers + state.thread_index() - 1);
+            }
+        }
+    }
+    yoshi::PerfCounters::instance().stop();
+    // per message handled by the thread
+    yoshi::PerfCounters::instance().setOperations(
+        state.thread_index() == 0 ? QUEUE_MESSAGES * producers : QUEUE_MESSAGES);
+    if (state.thread_index() == 0)
+    {
+        state.SetItemsProcessed(state.iterations() * QUEUE_MESSAGES * producers);
+        s_queue.reset();
+        if (not ordered)
+        {
+            state.SkipWithError("the messages of a producer are not in order");
+        }
+    }
+}
+
+/// Queues with a single producer and a single consumer
+#define DECLARE_SPSC_TESTS(C) \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(spscArgs, RoundTrip_Latency, int64_t, C) \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(spscArgs, Throughput, int64_t, C)
+
+/// Queues with several producers, the throughput going from 1 to N producers
+#define DECLARE_MPMC_TESTS(C) \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(spscArgs, RoundTrip_Latency, int64_t, C) \
+    YOSHI_ADD_SHORT_BENCHMARK_WITH(mpscArgs, Throughput, int64_t, C)
@@ -0,0 +1,4 @@
+#include "spsc_ring.hpp"
+#include "tests.hpp"
+
+DECLARE_SPSC_TESTS(yoshi::SpscRing)
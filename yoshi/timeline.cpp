@@ -0,0 +1,39 @@
+#include "timeline.hpp"
+#include "latency.hpp"
+#include "options.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace yoshi {
+namespace timeline {
+
+std::string& current()
+{
+    static std::string s_name;
+    return s_name;
+}
+
+void write(std::int64_t size, const std::vector<Point>& points)
+{
+    static bool s_started = false;
+    std::ofstream file(options().timeline, s_started ? std::ios::app : std::ios::trunc);
+    if (not file)
+    {
+        throw std::runtime_error("can not open the timeline file " + options().timeline);
+    }
+    if (not s_started)
+    {
+        file << "benchmark,size,index,ns,live_bytes\n";
+        s_started = true;
+    }
+    const double ticks = latency::ticksPerNanosecond();
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        file << '"' << current() << "\"," << size << ',' << i << ','
+             << static_cast<std::int64_t>(points[i].ticks / ticks) << ',' << points[i].live << '\n';
+    }
+}
+
+}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace yoshi {
+namespace timeline {
+
+/// One operation of a timeline
+struct Point
+{
+    /// Latency in ticks of latency::start()/stop()
+    std::uint64_t ticks = 0;
+    /// Bytes allocated after the operation (see memory::Stats::live)
+    std::int64_t live = 0;
+};
+
+/// Name of the running benchmark, set by the yoshi main
+std::string& current();
+
+/// Appends the points of the running benchmark with the argument `size` to the
+/// CSV file of the timeline option (see yoshi::Options), one line per operation:
+/// benchmark,size,index,ns,live_bytes. The file is truncated on the first write.
+void write(std::int64_t size, const std::vector<Point>& points);
+
+}
+}
@@ -0,0 +1,164 @@
+#include "trace.hpp"
+#include "options.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <queue>
+#include <random>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace yoshi {
+namespace trace {
+namespace {
+/// Event planned at a time of the trace
+struct Scheduled
+{
+    std::uint64_t time;
+    Event event;
+
+    bool operator>(const Scheduled& other) const { return time > other.time; }
+};
+}
+
+std::vector<Event> generate(std::size_t count, const Model& model)
+{
+    std::mt19937_64 generator(model.seed);
+    std::lognormal_distribution<double> lifetime(std::log(model.medianLifetime), model.sigma);
+    std::geometric_distribution<int> modifies(1.0 / (1.0 + model.modifies));
+    std::uniform_int_distribution<std::uint32_t> payload(model.minPayload, model.maxPayload);
+    // several feeds share the id sequence, so the ids of a feed have gaps
+    std::uniform_int_distribution<std::uint64_t> gap(1, 4);
+
+    std::priority_queue<Scheduled, std::vector<Scheduled>, std::greater<Scheduled>> scheduled;
+    std::vector<Event> events;
+    events.reserve(count);
+    std::uint64_t id = 0;
+    for (std::uint64_t time = 0; events.size() < count; ++time)
+    {
+        if (not scheduled.empty() and scheduled.top().time <= time)
+        {
+            events.push_back(scheduled.top().event);
+            scheduled.pop();
+            continue;
+        }
+        id += gap(generator);
+        const Event add{id, payload(generator), Op::ADD, {}};
+        events.push_back(add);
+        const auto life = static_cast<std::uint64_t>(std::max(1.0, std::round(lifetime(generator))));
+        if (life > 1)
+        {
+            std::uniform_int_distribution<std::uint64_t> when(1, life - 1);
+            for (int m = modifies(generator); m > 0; --m)
+            {
+                scheduled.push({time + when(generator), {id, add.payload, Op::MODIFY, {}}});
+            }
+        }
+        scheduled.push({time + life, {id, 0, Op::CANCEL, {}}});
+    }
+    return events;
+}
+
+void write(const std::string& path, const std::vector<Event>& events)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.eventSize = sizeof(Event);
+    header.count = events.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(events.data()), events.size() * sizeof(Event));
+    if (not file)
+    {
+        throw std::runtime_error("can not write the trace " + path);
+    }
+}
+
+Trace::Trace(const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd == -1)
+    {
+        throw std::runtime_error("can not open the trace " + path);
+    }
+    struct stat st;
+    if (fstat(fd, &st) == 0 and st.st_size >= static_cast<off_t>(sizeof(Header)))
+    {
+        m_length = st.st_size;
+        m_mapping = mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);
+    if (m_mapping == nullptr or m_mapping == MAP_FAILED)
+    {
+        m_mapping = nullptr;
+        throw std::runtime_error("can not map the trace " + path);
+    }
+    madvise(m_mapping, m_length, MADV_SEQUENTIAL);
+
+    Header header;
+    std::memcpy(&header, m_mapping, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+        or header.version != VERSION
+        or header.eventSize != sizeof(Event)
+        or header.count > (m_length - sizeof(Header)) / sizeof(Event))
+    {
+        munmap(m_mapping, m_length);
+        m_mapping = nullptr;
+        throw std::runtime_error(path + " is not a trace or is truncated");
+    }
+    m_begin = reinterpret_cast<const Event*>(static_cast<const char*>(m_mapping) + sizeof(Header));
+    m_size = header.count;
+}
+
+Trace::Trace(std::vector<Event> events)
+    : m_events(std::move(events))
+    , m_begin(m_events.data())
+    , m_size(m_events.size())
+{
+}
+
+Trace::~Trace()
+{
+    if (m_mapping != nullptr)
+    {
+        munmap(m_mapping, m_length);
+    }
+}
+
+std::uint32_t Trace::maxPayload() const
+{
+    std::uint32_t max = 0;
+    for (const auto& e : *this)
+    {
+        max = std::max(max, e.payload);
+    }
+    return max;
+}
+
+const Trace& get(std::size_t count)
+{
+    if (not options().trace.empty())
+    {
+        static const Trace s_file(options().trace);
+        return s_file;
+    }
+    static std::map<std::size_t, std::unique_ptr<Trace>> s_traces;
+    auto& trace = s_traces[count];
+    if (not trace)
+    {
+        trace = std::make_unique<Trace>(generate(count));
+    }
+    return *trace;
+}
+
+}
+}
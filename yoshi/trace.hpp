@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Traces of order book events (add/modify/cancel of orders) replayed on the
+/// containers, recorded from production traffic or generated.
+///
+/// File format, little endian: a Header followed by Header::count Event.
+namespace yoshi {
+namespace trace {
+
+enum class Op : std::uint8_t
+{
+    ADD = 0,
+    MODIFY = 1,
+    CANCEL = 2,
+};
+
+struct Event
+{
+    /// Order id
+    std::uint64_t key;
+    /// Size in bytes of the order data
+    std::uint32_t payload;
+    Op op;
+    std::uint8_t reserved[3];
+};
+static_assert(sizeof(Event) == 16, "the events are written as is");
+
+struct Header
+{
+    char magic[8];
+    std::uint32_t version;
+    /// sizeof(Event)
+    std::uint32_t eventSize;
+    std::uint64_t count;
+};
+
+constexpr char MAGIC[8] = {'Y', 'O', 'S', 'H', 'I', 'T', 'R', 'C'};
+constexpr std::uint32_t VERSION = 1;
+
+/// Parameters of the synthetic traces
+struct Model
+{
+    /// Median lifetime of an order, in number of events
+    double medianLifetime = 10000;
+    /// Standard deviation of the log of the lifetime (log-normal lifetimes)
+    double sigma = 2.0;
+    /// Average number of modifications of an order
+    double modifies = 0.5;
+    std::uint32_t minPayload = 24;
+    std::uint32_t maxPayload = 64;
+    std::uint64_t seed = 0;
+};
+
+/// Generates `count` events: the orders are added with increasing ids, live
+/// for a log-normal number of events, are modified a geometric number of
+/// times meanwhile and then cancelled. The orders still alive at the end of
+/// the trace are not cancelled.
+std::vector<Event> generate(std::size_t count, const Model& model = Model());
+
+/// Writes a trace file, throws std::runtime_error on failure
+void write(const std::string& path, const std::vector<Event>& events);
+
+/// Events of a trace, either mapped from a file or held in memory
+class Trace
+{
+public:
+    /// Maps the trace file `path` in memory, throws std::runtime_error if it
+    /// can not be read or is not a trace
+    explicit Trace(const std::string& path);
+    explicit Trace(std::vector<Event> events);
+    ~Trace();
+    Trace(const Trace&) = delete;
+    Trace& operator=(const Trace&) = delete;
+
+    const Event* begin() const { return m_begin; }
+    const Event* end() const { return m_begin + m_size; }
+    std::size_t size() const { return m_size; }
+    /// Highest payload of the events
+    std::uint32_t maxPayload() const;
+
+private:
+    std::vector<Event> m_events;
+    void* m_mapping = nullptr;
+    std::size_t m_length = 0;
+    const Event* m_begin = nullptr;
+    std::size_t m_size = 0;
+};
+
+/// Returns the trace of the run: the file given on the command line (see
+/// yoshi::Options), else a synthetic trace of `count` events generated once
+/// and shared by all the benchmarks
+const Trace& get(std::size_t count);
+
+}
+}
@@ -1,8 +1,15 @@
 #include "yoshi.hpp"
+#include "options.hpp"
 
 #include <iostream>
 
 namespace yoshi {
+Options& options()
+{
+    static Options s_options;
+    return s_options;
+}
+
 namespace internal {
 Benchmark* add(Benchmark* b)
 {
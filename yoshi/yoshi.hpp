@@ -12,13 +12,18 @@ namespace internal {
 struct Benchmark
 {
     using Function = std::function<void(benchmark::State&)>;
+    /// Applies the arguments to the google benchmark, `sizes` being the list
+    /// of sizes selected from the command line. By default one Arg per size.
+    using Configure = std::function<void(benchmark::internal::Benchmark*, const std::vector<int64_t>& sizes)>;
     std::string name;
     Function benchmark;
     bool shortArgs;
-    Benchmark(const char* n, Function f, bool s = false)
+    Configure configure;
+    Benchmark(const char* n, Function f, bool s = false, Configure c = Configure())
         : name(n)
         , benchmark(f)
         , shortArgs(s)
+        , configure(c)
     {
     }
 };
@@ -42,6 +47,21 @@ private:
 
 Benchmark* add(Benchmark* b);
 
+/// Adds the benchmark calling `f` only if Condition: `f` is not instantiated
+/// otherwise, so the benchmark does not need to compile for the types without it
+template <bool Condition, typename F>
+Benchmark* addIf(const char* name, F f, bool shortArgs, Benchmark::Configure configure)
+{
+    if constexpr (Condition)
+    {
+        return add(new Benchmark(name, f, shortArgs, configure));
+    }
+    else
+    {
+        return nullptr;
+    }
+}
+
 }
 }
 // Macro to register benchmarks
@@ -76,3 +96,33 @@ Benchmark* add(Benchmark* b);
                 #f "<" #__VA_ARGS__ ">",                            \
                 [](auto& st) { f<__VA_ARGS__>(st);},               \
                 true));
+
+// Same as above but the arguments are applied by the given configure
+// function (see yoshi::internal::Benchmark::Configure)
+#define YOSHI_ADD_BENCHMARK_WITH(configure, f, ...)                 \
+    static yoshi::internal::Benchmark*                              \
+        YOSHI_PRIVATE_NAME(f) = yoshi::internal::add(               \
+            new yoshi::internal::Benchmark(                         \
+                #f "<" #__VA_ARGS__ ">",                            \
+                [](auto& st) { f<__VA_ARGS__>(st);},               \
+                false,                                              \
+                configure));
+
+// Same as YOSHI_ADD_BENCHMARK_WITH but the benchmark is only added if
+// `condition`, a parenthesized constant expression, is true
+#define YOSHI_ADD_BENCHMARK_IF(condition, configure, f, ...)        \
+    static yoshi::internal::Benchmark*                              \
+        YOSHI_PRIVATE_NAME(f) = yoshi::internal::addIf<condition>(  \
+            #f "<" #__VA_ARGS__ ">",                                \
+            [](auto& st) { f<__VA_ARGS__>(st);},                   \
+            false,                                                  \
+            configure);
+
+#define YOSHI_ADD_SHORT_BENCHMARK_WITH(configure, f, ...)           \
+    static yoshi::internal::Benchmark*                              \
+        YOSHI_PRIVATE_NAME(f) = yoshi::internal::add(               \
+            new yoshi::internal::Benchmark(                         \
+                #f "<" #__VA_ARGS__ ">",                            \
+                [](auto& st) { f<__VA_ARGS__>(st);},               \
+                true,                                               \
+                configure));
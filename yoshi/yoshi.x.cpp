@@ -1,4 +1,11 @@
 #include "yoshi.hpp"
+#include "affinity.hpp"
+#include "context.hpp"
+#include "latency.hpp"
+#include "options.hpp"
+#include "perf_counters.hpp"
+#include "timeline.hpp"
+#include "trace.hpp"
 
 #include <iostream>
 #include <boost/program_options.hpp>
@@ -15,13 +22,30 @@ int main(int argc, char** argv)
         po::options_description desc{"Options"};
         desc.add_options()
         ("help,h", "Help screen")
-        ("short,s", po::bool_switch()->default_value(false), "Short mode");
+        ("short,s", po::bool_switch()->default_value(false), "Short mode")
+        ("perf-counters,p", po::bool_switch()->default_value(false),
+         "Collect the hardware performance counters on the timed regions")
+        ("latency,l", po::bool_switch()->default_value(false),
+         "Record the latency of each operation and report the percentiles")
+        ("trace,t", po::value<std::string>()->default_value(""),
+         "Trace file replayed by the trace benchmarks, instead of a synthetic trace")
+        ("timeline", po::value<std::string>()->default_value(""),
+         "CSV file receiving the latency and memory of each operation of the timeline benchmarks")
+        ("cpus,c", po::value<std::string>()->default_value(""),
+         "CPUs on which the threads of the multi-threaded benchmarks are pinned, by thread index (like 0,2,8-11), "
+         "the CPUs allowed to the process by default");
 
         po::variables_map vm;
         po::store(parse_command_line(argc, argv, desc), vm);
         po::notify(vm);
         bool help = vm.count("help");
         short_run = vm["short"].as<bool>();
+        yoshi::options().shortRun = short_run;
+        yoshi::options().perfCounters = vm["perf-counters"].as<bool>();
+        yoshi::options().latency = vm["latency"].as<bool>();
+        yoshi::options().trace = vm["trace"].as<std::string>();
+        yoshi::options().timeline = vm["timeline"].as<std::string>();
+        yoshi::options().cpus = yoshi::parseCpus(vm["cpus"].as<std::string>());
         if (help)
         {
             std::cout << desc << "\n";
@@ -32,32 +56,94 @@ int main(int argc, char** argv)
         std::cerr << ex.what() << '\n';
         return 1;
     }
+    catch (const std::invalid_argument& ex)
+    {
+        std::cerr << ex.what() << '\n';
+        return 1;
+    }
+    if (not yoshi::options().trace.empty())
+    {
+        try
+        {
+            yoshi::trace::get(0);
+        }
+        catch (const std::exception& ex)
+        {
+            std::cerr << ex.what() << '\n';
+            return 1;
+        }
+    }
     const auto& benchmarks = yoshi::internal::Benchmarks::instance()->get();
     for(auto& b : benchmarks)
     {
-        auto bench = benchmark::RegisterBenchmark(b->name.c_str(), b->benchmark);
+        auto function = b->benchmark;
+        if (yoshi::options().perfCounters)
+        {
+            function = [f = function](benchmark::State& st)
+            {
+                auto& counters = yoshi::PerfCounters::instance();
+                if (counters.open())
+                {
+                    counters.reset();
+                }
+                f(st);
+                counters.stop();
+                counters.report(st);
+            };
+        }
+        if (yoshi::options().latency)
+        {
+            function = [f = function](benchmark::State& st)
+            {
+                yoshi::latency::histogram().reset();
+                f(st);
+                yoshi::latency::report(st);
+            };
+        }
+        if (not yoshi::options().timeline.empty())
+        {
+            function = [f = function, name = b->name](benchmark::State& st)
+            {
+                yoshi::timeline::current() = name;
+                f(st);
+            };
+        }
+        auto bench = benchmark::RegisterBenchmark(b->name.c_str(), function);
+        std::vector<int64_t> sizes;
         if (short_run)
         {
             if (b->shortArgs)
             {
-                bench->Arg(1024)->Arg(8192);
+                sizes = {1024, 8192};
             }
             else
             {
-                bench->Arg(10000)->Arg(250000);
+                sizes = {10000, 250000};
             }
         }
         else
         {
             if (b->shortArgs)
             {
-                bench->Arg(1000)->Arg(5000)->Arg(10000)->Arg(25000)->Arg(50000)->Arg(75000)->Arg(100000);
+                sizes = {1000, 5000, 10000, 25000, 50000, 75000, 100000};
             }
             else
             {
-                bench->Arg(1000)->Arg(10000)->Arg(50000)->Arg(100000)->Arg(250000)->Arg(500000)->Arg(750000)->Arg(1000000);
+                sizes = {1000, 10000, 50000, 100000, 250000, 500000, 750000, 1000000};
+            }
+        }
+        if (b->configure)
+        {
+            b->configure(bench, sizes);
+        }
+        else
+        {
+            for (auto size : sizes)
+            {
+                bench->Arg(size);
             }
         }
     }
+    yoshi::addContext();
     benchmark::RunSpecifiedBenchmarks();
 }